@@ -0,0 +1,417 @@
+#ifndef __ASYNCFILE_H__
+#define __ASYNCFILE_H__
+
+#include <queue>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <system_error>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "logger.h"
+#include "taskFuture.h"
+
+// 异步文件I/O的实现方式
+enum class FileIoMode {
+    MODE_AUTO,          // 优先使用io_uring，不可用时使用阻塞I/O线程组
+    MODE_BLOCKING       // 始终使用阻塞I/O线程组
+};
+
+// 异步文件读写 - 基于io_uring，不可用时退化为专用的阻塞I/O线程组
+/*
+    - 所有线程共享一个io_uring实例，提交时加锁写入提交队列并调用io_uring_enter
+    - 完成事件通过注册到io_uring的eventfd通知，由专用的完成线程收割，提交线程也会顺带收割已完成的请求，
+      结果通过TaskFuture返回；工作线程在任务中阻塞等待future时，请求同样能够完成
+    - 设置结果后在完成请求的线程（完成线程、阻塞I/O线程或顺带收割的提交线程）上触发完成通知，
+      因此结果可用于onComplete/when_all/when_any，回调不应长时间阻塞
+    - io_uring_enter提交失败时，撤销该提交队列项，future以对应的errno抛出std::system_error
+    - 在途请求达到队列深度时，新请求交给阻塞I/O线程组执行，保证完成队列不会溢出
+    - 内核不支持或禁止io_uring时（ENOSYS/EPERM等），所有请求由阻塞I/O线程组以pread/pwrite执行
+    - 成功时future的结果为读写的字节数，失败时抛出std::system_error
+*/
+class AsyncFileIO
+{
+public:
+    static const unsigned RING_ENTRIES = 256;       // 提交队列深度
+    static const size_t BLOCKING_THREADS = 4;       // 阻塞I/O线程组的线程数量
+
+    // 构造函数
+    explicit AsyncFileIO(FileIoMode mode = FileIoMode::MODE_AUTO)
+        : ringFd_(-1)
+        , completionFd_(-1)
+        , wakeupFd_(-1)
+        , inflight_(0)
+        , isExit_(false)
+    {
+        if(mode == FileIoMode::MODE_AUTO && !setupRing()) {
+            destroyRing();
+        }
+
+        // io_uring可用时启动完成线程
+        if(usingUring()) {
+            completionThread_ = std::thread(&AsyncFileIO::completionFunc, this);
+        }
+
+        // 阻塞I/O线程组始终创建，用于io_uring不可用或提交队列已满时
+        for(size_t i = 0; i < BLOCKING_THREADS; ++i) {
+            blockingThreads_.emplace_back(&AsyncFileIO::blockingFunc, this);
+        }
+    }
+
+    // 析构函数，等待所有在途请求完成
+    ~AsyncFileIO() {
+        // 先停止完成线程，剩余的在途请求由析构函数收割
+        if(completionThread_.joinable()) {
+            ringExit_ = true;
+            wakeup();
+            completionThread_.join();
+        }
+
+        if(usingUring()) {
+            while(inflight_ > 0) {
+                syscall(__NR_io_uring_enter, ringFd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                std::lock_guard<std::mutex> lock(cqMtx_);
+                reapRing();
+            }
+        }
+        destroyRing();
+
+        {
+            std::lock_guard<std::mutex> lock(blockingMtx_);
+            isExit_ = true;
+        }
+        blockingCond_.notify_all();
+        for(auto& t : blockingThreads_) {
+            t.join();
+        }
+    }
+
+    // 禁止拷贝构造/赋值
+    AsyncFileIO(const AsyncFileIO&) = delete;
+    AsyncFileIO& operator=(const AsyncFileIO&) = delete;
+
+    // 是否使用io_uring
+    bool usingUring() const {
+        return ringFd_ >= 0;
+    }
+
+    // 从fd的offset处读取size字节到buffer，buffer在future就绪前必须保持有效
+    TaskFuture<ssize_t> read(int fd, void* buffer, size_t size, off_t offset) {
+        return submit(std::make_unique<Request>(IORING_OP_READ, fd, buffer, size, offset));
+    }
+
+    // 将buffer中的size字节写入fd的offset处，buffer在future就绪前必须保持有效
+    TaskFuture<ssize_t> write(int fd, const void* buffer, size_t size, off_t offset) {
+        return submit(std::make_unique<Request>(IORING_OP_WRITE, fd, const_cast<void*>(buffer), size, offset));
+    }
+
+    // 等待完成事件并收割，由完成线程调用
+    bool poll(int timeoutMs) {
+        pollfd fds[2];
+        fds[0].fd = completionFd_;
+        fds[0].events = POLLIN;
+        fds[1].fd = wakeupFd_;
+        fds[1].events = POLLIN;
+        if(::poll(fds, 2, timeoutMs) <= 0) {
+            return false;
+        }
+
+        // 先清空eventfd再收割，之后到达的完成事件会再次触发eventfd
+        uint64_t value;
+        if(fds[0].revents & POLLIN) {
+            ssize_t ret = ::read(completionFd_, &value, sizeof(value));
+            (void)ret;
+        }
+        if(fds[1].revents & POLLIN) {
+            ssize_t ret = ::read(wakeupFd_, &value, sizeof(value));
+            (void)ret;
+        }
+
+        std::lock_guard<std::mutex> lock(cqMtx_);
+        return reapRing() > 0;
+    }
+
+    // 唤醒阻塞在poll()中的线程
+    void wakeup() {
+        uint64_t value = 1;
+        ssize_t ret = ::write(wakeupFd_, &value, sizeof(value));
+        (void)ret;
+    }
+
+private:
+    // 异步读写请求，io_uring路径下以其地址作为user_data
+    struct Request
+    {
+        Request(int op, int fd, void* buffer, size_t size, off_t offset)
+            : op(op), fd(fd), buffer(buffer), size(size), offset(offset)
+            , completion(std::make_shared<TaskCompletion>())
+        {}
+
+        int op;                                         // IORING_OP_READ / IORING_OP_WRITE
+        int fd;                                         // 文件描述符
+        void* buffer;                                   // 读写缓冲区
+        size_t size;                                    // 字节数
+        off_t offset;                                   // 文件偏移
+        std::promise<ssize_t> promise;                  // 结果
+        std::shared_ptr<TaskCompletion> completion;     // 完成通知
+    };
+
+    // 提交请求
+    TaskFuture<ssize_t> submit(std::unique_ptr<Request> request) {
+        TaskFuture<ssize_t> result(request->promise.get_future(), request->completion);
+
+        // 在途请求数量不超过队列深度，保证完成队列不会溢出
+        if(usingUring() && inflight_.fetch_add(1) < RING_ENTRIES) {
+            int err = submitRing(request.get());
+            if(err != 0) {
+                // 提交失败，请求不会产生完成事件
+                inflight_--;
+                complete(*request, -err);
+                return result;
+            }
+            request.release();
+
+            // 顺带收割已完成的请求，其它线程正在收割时跳过
+            std::unique_lock<std::mutex> lock(cqMtx_, std::try_to_lock);
+            if(lock.owns_lock()) {
+                reapRing();
+            }
+            return result;
+        }
+        if(usingUring()) {
+            inflight_--;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(blockingMtx_);
+            blockingQue_.emplace(std::move(request));
+        }
+        blockingCond_.notify_one();
+        return result;
+    }
+
+    // 设置结果并触发完成通知
+    static void complete(Request& request, ssize_t res) {
+        if(res < 0) {
+            request.promise.set_exception(std::make_exception_ptr(
+                std::system_error(static_cast<int>(-res), std::generic_category(),
+                                  request.op == IORING_OP_READ ? "async read" : "async write")));
+        }
+        else {
+            request.promise.set_value(res);
+        }
+        request.completion->fire();
+    }
+
+    //// io_uring
+
+    // 创建io_uring实例并映射提交/完成队列
+    bool setupRing() {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+        if(ringFd_ < 0) {
+            LOG_WARN() << "io_uring unavailable (" << strerror(errno) << "), using blocking I/O threads";
+            return false;
+        }
+
+        // 提交队列与完成队列的环形缓冲区，内核支持时二者共用一次映射
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if(singleMmap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+        if(sqRing_ == MAP_FAILED) {
+            sqRing_ = nullptr;
+            return false;
+        }
+        cqRing_ = singleMmap ? sqRing_ :
+            mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+        if(cqRing_ == MAP_FAILED) {
+            cqRing_ = nullptr;
+            return false;
+        }
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+        if(sqes == MAP_FAILED) {
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // 完成事件通知与唤醒使用的eventfd
+        completionFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        wakeupFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(completionFd_ < 0 || wakeupFd_ < 0 ||
+           syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_EVENTFD, &completionFd_, 1) < 0) {
+            LOG_WARN() << "io_uring eventfd registration failed (" << strerror(errno) << "), using blocking I/O threads";
+            return false;
+        }
+        return true;
+    }
+
+    // 释放io_uring资源
+    void destroyRing() {
+        if(sqes_ != nullptr) {
+            munmap(sqes_, sqesSize_);
+            sqes_ = nullptr;
+        }
+        if(cqRing_ != nullptr && cqRing_ != sqRing_) {
+            munmap(cqRing_, cqRingSize_);
+        }
+        cqRing_ = nullptr;
+        if(sqRing_ != nullptr) {
+            munmap(sqRing_, sqRingSize_);
+            sqRing_ = nullptr;
+        }
+        if(ringFd_ >= 0) {
+            close(ringFd_);
+            ringFd_ = -1;
+        }
+        if(completionFd_ >= 0) {
+            close(completionFd_);
+            completionFd_ = -1;
+        }
+        if(wakeupFd_ >= 0) {
+            close(wakeupFd_);
+            wakeupFd_ = -1;
+        }
+    }
+
+    // 写入一个提交队列项并通知内核，成功时返回0，失败时撤销该提交队列项并返回errno
+    int submitRing(Request* request) {
+        std::lock_guard<std::mutex> lock(sqMtx_);
+
+        unsigned tail = *sqTail_;
+        unsigned index = tail & sqMask_;
+        io_uring_sqe& sqe = sqes_[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = static_cast<uint8_t>(request->op);
+        sqe.fd = request->fd;
+        sqe.addr = reinterpret_cast<uint64_t>(request->buffer);
+        sqe.len = static_cast<uint32_t>(request->size);
+        sqe.off = static_cast<uint64_t>(request->offset);
+        sqe.user_data = reinterpret_cast<uint64_t>(request);
+        sqArray_[index] = index;
+
+        // 先写入提交项，再发布新的队尾
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+        // 未使用SQPOLL，提交项只在io_uring_enter中被内核消费；返回值小于1表示未被消费，在持有sqMtx_时撤销队尾
+        long ret = syscall(__NR_io_uring_enter, ringFd_, 1, 0, 0, nullptr, 0);
+        if(ret < 1) {
+            int err = ret < 0 ? errno : EAGAIN;
+            __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+            LOG_ERROR() << "io_uring_enter failed: " << strerror(err);
+            return err;
+        }
+        return 0;
+    }
+
+    // 完成线程，阻塞等待完成事件并收割，直到析构
+    void completionFunc() {
+        while(!ringExit_) {
+            poll(-1);
+        }
+    }
+
+    // 收割所有已完成的请求，返回收割的数量，调用时需持有cqMtx_
+    size_t reapRing() {
+        unsigned head = *cqHead_;
+        unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+        size_t reaped = 0;
+        for(; head != tail; ++head, ++reaped) {
+            io_uring_cqe& cqe = cqes_[head & cqMask_];
+            std::unique_ptr<Request> request(reinterpret_cast<Request*>(cqe.user_data));
+            complete(*request, cqe.res);
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+
+        inflight_ -= reaped;
+        return reaped;
+    }
+
+    //// 阻塞I/O线程组
+
+    // 阻塞I/O线程，以pread/pwrite执行请求
+    void blockingFunc() {
+        for(;;) {
+            std::unique_ptr<Request> request;
+            {
+                std::unique_lock<std::mutex> lock(blockingMtx_);
+                blockingCond_.wait(lock, [&]()->bool{
+                    return isExit_ || !blockingQue_.empty();
+                });
+                if(blockingQue_.empty()) {
+                    return;
+                }
+                request = std::move(blockingQue_.front());
+                blockingQue_.pop();
+            }
+
+            ssize_t res = request->op == IORING_OP_READ ?
+                pread(request->fd, request->buffer, request->size, request->offset) :
+                pwrite(request->fd, request->buffer, request->size, request->offset);
+            complete(*request, res < 0 ? -errno : res);
+        }
+    }
+
+private:
+    //// io_uring
+    int ringFd_;                                        // io_uring实例
+    int completionFd_;                                  // 完成事件通知
+    int wakeupFd_;                                      // 唤醒轮询线程
+    void* sqRing_ = nullptr;                            // 提交队列环形缓冲区
+    void* cqRing_ = nullptr;                            // 完成队列环形缓冲区
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;                      // 提交队列项
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;                      // 完成队列项
+    std::mutex sqMtx_;                                  // 保证提交队列的线程安全
+    std::mutex cqMtx_;                                  // 保证完成队列的线程安全
+    std::atomic_uint inflight_;                         // 在途请求数量
+    std::atomic_bool ringExit_{false};                  // 完成线程是否退出
+    std::thread completionThread_;                      // 完成线程
+
+    //// 阻塞I/O线程组
+    std::queue<std::unique_ptr<Request>> blockingQue_;  // 待执行的请求
+    std::mutex blockingMtx_;                            // 保证请求队列的线程安全
+    std::condition_variable blockingCond_;              // 请求队列不空或退出
+    bool isExit_;                                       // 是否退出
+    std::vector<std::thread> blockingThreads_;          // 阻塞I/O线程
+};
+
+#endif
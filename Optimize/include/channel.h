@@ -0,0 +1,290 @@
+#ifndef __CHANNEL_H__
+#define __CHANNEL_H__
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <optional>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "threadpoolOpt.h"
+
+// 有界多生产者多消费者通道
+/*
+    - 数据存放在无锁环形缓冲区中（每个槽位带序号的有界MPMC队列），收发在不阻塞时只有一次CAS
+    - 通道已满/为空时：
+        在线程池的工作线程中，先协助执行线程池中的其它任务（例如通道另一端的任务），
+        没有可执行的任务时才短暂阻塞，每HELP_INTERVAL醒来一次重新检查线程池任务；
+        其它线程直接阻塞在条件变量上
+    - 协助执行的任务嵌套在等待者的调用栈上：协助执行的任务自身阻塞在等待被压在其下方的任务时无法继续，
+      例如只有一个工作线程时，收发两端都是线程池中长时间运行的任务会互相等待；
+      两端都在线程池中时，同时阻塞的长时间运行任务数量应小于工作线程数量
+    - 互斥锁只用于阻塞与唤醒，没有等待者时收发不加锁，也不调用notify
+    - close()后send()返回false，recv()取完剩余数据后返回std::nullopt；
+      与close()并发进行的send()可能成功，其数据仍可被recv()取到
+    - Pool为协助执行任务的线程池类型，默认为ThreadPool，可为任意策略组合的BasicThreadPool
+
+    使用示例：
+        Channel<Block> channel(pool, 64);
+        pool.submitTask([&]() { while(auto block = read()) channel.send(std::move(*block)); channel.close(); });
+        pool.submitTask([&]() { while(auto block = channel.recv()) write(*block); });
+*/
+template<typename T, typename Pool = ThreadPool>
+class Channel
+{
+public:
+    static constexpr std::chrono::milliseconds HELP_INTERVAL{1};   // 工作线程阻塞时重新检查线程池任务的间隔
+
+    // 构造函数，capacity向上取整为2的幂；pool为空时阻塞不协助执行任务
+    explicit Channel(size_t capacity, Pool* pool = nullptr)
+        : pool_(pool)
+        , capacity_(roundUpPowerOfTwo(capacity))
+        , mask_(capacity_ - 1)
+        , cells_(new Cell[capacity_])
+        , closed_(false)
+        , sendWaiters_(0)
+        , recvWaiters_(0)
+    {
+        for(size_t i = 0; i < capacity_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    Channel(Pool& pool, size_t capacity)
+        : Channel(capacity, &pool)
+    {}
+
+    // 析构函数，销毁未被取走的数据
+    ~Channel() {
+        while(tryPop()) {}
+    }
+
+    // 禁止对通道进行拷贝构造/赋值
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // 发送数据，通道已满时等待，通道已关闭时返回false
+    bool send(T value) {
+        for(;;) {
+            if(closed_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if(tryPush(value)) {
+                notifyWaiters(recvWaiters_, notEmpty_);
+                return true;
+            }
+            waitFor(sendWaiters_, notFull_, [&]()->bool{
+                return isClosed() || !full();
+            });
+        }
+    }
+
+    // 尝试发送数据，通道已满或已关闭时返回false，value保持不变
+    bool trySend(T& value) {
+        if(closed_.load(std::memory_order_acquire) || !tryPush(value)) {
+            return false;
+        }
+        notifyWaiters(recvWaiters_, notEmpty_);
+        return true;
+    }
+
+    bool trySend(T&& value) {
+        return trySend(value);
+    }
+
+    // 接收数据，通道为空时等待，通道已关闭且数据已取完时返回std::nullopt
+    std::optional<T> recv() {
+        for(;;) {
+            if(std::optional<T> value = tryPop()) {
+                notifyWaiters(sendWaiters_, notFull_);
+                return value;
+            }
+            if(closed_.load(std::memory_order_acquire)) {
+                // 关闭前写入的数据仍需取完
+                std::optional<T> value = tryPop();
+                if(value) {
+                    notifyWaiters(sendWaiters_, notFull_);
+                }
+                return value;
+            }
+            waitFor(recvWaiters_, notEmpty_, [&]()->bool{
+                return isClosed() || !empty();
+            });
+        }
+    }
+
+    // 尝试接收数据，通道为空时返回std::nullopt
+    std::optional<T> tryRecv() {
+        std::optional<T> value = tryPop();
+        if(value) {
+            notifyWaiters(sendWaiters_, notFull_);
+        }
+        return value;
+    }
+
+    // 关闭通道，唤醒所有等待者
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(mtx_);
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+    bool isClosed() const {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    // 通道容量
+    size_t capacity() const {
+        return capacity_;
+    }
+
+private:
+    // 环形缓冲区槽位，seq等于写入位置时可写，等于写入位置+1时可读
+    struct Cell
+    {
+        std::atomic<size_t> seq;                                    // 槽位序号
+        alignas(T) unsigned char storage[sizeof(T)];                // 数据
+    };
+
+    // 写入一个数据，成功时移走value
+    bool tryPush(T& value) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for(;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if(diff == 0) {
+                if(enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if(diff < 0) {
+                // 槽位尚未被读取，通道已满
+                return false;
+            }
+            else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->storage) T(std::move(value));
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 读取一个数据
+    std::optional<T> tryPop() {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for(;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if(diff == 0) {
+                if(dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if(diff < 0) {
+                // 槽位尚未被写入，通道为空
+                return std::nullopt;
+            }
+            else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* slot = std::launder(reinterpret_cast<T*>(cell->storage));
+        std::optional<T> value(std::move(*slot));
+        slot->~T();
+        cell->seq.store(pos + capacity_, std::memory_order_release);
+        return value;
+    }
+
+    // 近似判断通道是否已满/为空，仅用于等待条件
+    // 先读取的位置可能已过时，只会使判断偏向等待，等待者已登记，之后的收发会将其唤醒
+    bool full() const {
+        size_t dequeuePos = dequeuePos_.load(std::memory_order_seq_cst);
+        return enqueuePos_.load(std::memory_order_seq_cst) - dequeuePos >= capacity_;
+    }
+
+    bool empty() const {
+        return enqueuePos_.load(std::memory_order_seq_cst) == dequeuePos_.load(std::memory_order_seq_cst);
+    }
+
+    // 等待条件成立
+    /*
+        等待者在持锁期间登记并重新检查条件，唤醒方在修改数据后检查等待者数量，
+        两侧均以seq_cst保证：唤醒方看到等待者数量为0时，等待者必然能看到数据的修改，不会丢失唤醒
+    */
+    template<typename Pred>
+    void waitFor(std::atomic<size_t>& waiters, std::condition_variable& cond, Pred ready) {
+        bool inPoolThread = pool_ != nullptr && pool_->isInPoolThread();
+
+        // 工作线程先协助执行线程池中的任务
+        if(inPoolThread && pool_->runPendingTask()) {
+            return;
+        }
+
+        // 让出一次CPU，对端通常能在此期间完成收发，避免进入条件变量
+        std::this_thread::yield();
+        if(ready()) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        if(!ready()) {
+            if(inPoolThread) {
+                cond.wait_for(lock, HELP_INTERVAL);
+            }
+            else {
+                cond.wait(lock);
+            }
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // 有等待者时唤醒一个
+    void notifyWaiters(std::atomic<size_t>& waiters, std::condition_variable& cond) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(waiters.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            cond.notify_one();
+        }
+    }
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t capacity = 2;
+        while(capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+private:
+    Pool* pool_;                                            // 阻塞时协助执行任务的线程池
+    const size_t capacity_;                                 // 容量，2的幂
+    const size_t mask_;                                     // 下标掩码
+    std::unique_ptr<Cell[]> cells_;                         // 环形缓冲区
+    alignas(64) std::atomic<size_t> enqueuePos_{0};         // 下一个写入位置
+    alignas(64) std::atomic<size_t> dequeuePos_{0};         // 下一个读取位置
+    alignas(64) std::atomic_bool closed_;                   // 是否已关闭
+
+    //// 阻塞与唤醒
+    std::atomic<size_t> sendWaiters_;                       // 等待通道未满的发送者数量
+    std::atomic<size_t> recvWaiters_;                       // 等待通道非空的接收者数量
+    std::mutex mtx_;                                        // 等待者的互斥锁
+    std::condition_variable notFull_;                       // 通道未满
+    std::condition_variable notEmpty_;                      // 通道非空
+};
+
+#endif
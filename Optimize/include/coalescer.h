@@ -0,0 +1,176 @@
+#ifndef __COALESCER_H__
+#define __COALESCER_H__
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+
+#include "threadpoolOpt.h"
+#include "taskGroup.h"
+
+// 任务合并提交的配置
+struct CoalesceOptions
+{
+    size_t initBatchSize = 64;                              // 初始批量大小
+    size_t maxBatchSize = 4096;                             // 批量大小上限
+    std::chrono::microseconds maxDelay{100};                // 任务在缓冲区中的最长停留时间
+    std::chrono::microseconds maxBatchTime{50};             // 单个批量任务的目标执行时间上限，避免并行度下降
+    bool adaptive = true;                                   // 是否根据实测开销自动调整批量大小
+};
+
+// 微小任务的合并提交器
+/*
+    - 每个生产者使用各自的合并提交器（非线程安全），任务先写入本地缓冲区，
+      缓冲区达到批量大小或最早的任务停留超过maxDelay时，合并为一个批量任务提交到线程池
+    - 自适应模式下，根据批量任务实测的单任务执行时间与提交开销调整批量大小：
+      使提交开销不超过批量执行时间的1/OVERHEAD_RATIO，同时批量执行时间不超过maxBatchTime
+    - 停留时间只在post()时检查，生产者停止提交后需调用flush()，析构时自动flush并等待完成
+    - 任务没有返回值，需要结果的任务请直接使用submitTask
+    - Pool为线程池类型，可为任意策略组合的BasicThreadPool，TaskCoalescer为默认线程池的别名
+*/
+template<typename Pool = ThreadPool>
+class BasicTaskCoalescer
+{
+public:
+    static const size_t OVERHEAD_RATIO = 10;        // 批量执行时间与提交开销之比的目标值
+
+    // 构造函数
+    explicit BasicTaskCoalescer(Pool& pool, const CoalesceOptions& options = CoalesceOptions())
+        : options_(options)
+        , group_(pool)
+        , stats_(std::make_shared<BatchStats>())
+        , batchSize_(std::max<size_t>(std::min(options.initBatchSize, options.maxBatchSize), 1))
+        , dispatchNs_(0)
+        , taskNs_(0)
+        , seenBatchNs_(0)
+        , seenBatchTasks_(0)
+    {
+        buffer_.reserve(batchSize_);
+    }
+
+    // 析构函数，提交剩余任务并等待全部完成
+    ~BasicTaskCoalescer() {
+        flush();
+    }
+
+    // 禁止对合并提交器进行拷贝构造/赋值
+    BasicTaskCoalescer(const BasicTaskCoalescer&) = delete;
+    BasicTaskCoalescer& operator=(const BasicTaskCoalescer&) = delete;
+
+    // 缓冲一个任务，达到批量大小或停留时间上限时提交
+    // 每次post()读取一次时钟，缓冲的任务较少时同样遵守maxDelay
+    template<typename taskFunc>
+    void post(taskFunc&& func) {
+        auto now = Clock::now();
+        if(buffer_.empty()) {
+            firstPostTime_ = now;
+        }
+        buffer_.emplace_back(std::forward<taskFunc>(func));
+
+        if(buffer_.size() >= batchSize_ || now - firstPostTime_ >= options_.maxDelay) {
+            flush();
+        }
+    }
+
+    // 立即提交缓冲区中的任务，用于对时延敏感的位置
+    void flush() {
+        if(buffer_.empty()) {
+            return;
+        }
+
+        std::vector<Task> tasks;
+        tasks.swap(buffer_);
+        buffer_.reserve(batchSize_);
+
+        // 批量任务统计自身的执行时间，供生产者估算单任务开销
+        std::shared_ptr<BatchStats> stats = stats_;
+        auto batch = [stats, tasks = std::move(tasks)]() {
+            auto begin = Clock::now();
+            for(auto& task : tasks) {
+                task();
+            }
+            stats->batchNs += toNs(Clock::now() - begin);
+            stats->batchTasks += tasks.size();
+        };
+
+        auto begin = Clock::now();
+        group_.run(std::move(batch));
+        uint64_t dispatchNs = toNs(Clock::now() - begin);
+
+        if(options_.adaptive) {
+            adjustBatchSize(dispatchNs);
+        }
+    }
+
+    // 提交缓冲区中的任务并等待已提交的任务全部完成，若任务抛出异常，则重新抛出第一个异常
+    void wait() {
+        flush();
+        group_.wait();
+    }
+
+    // 获取当前批量大小
+    size_t getBatchSize() const {
+        return batchSize_;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+
+    // 批量任务执行时间的累计值，由执行批量任务的工作线程写入
+    struct BatchStats
+    {
+        std::atomic<uint64_t> batchNs{0};           // 批量任务执行总时间
+        std::atomic<uint64_t> batchTasks{0};        // 批量任务中已执行的任务数量
+    };
+
+    // 根据提交开销与单任务执行时间的滑动平均调整批量大小
+    void adjustBatchSize(uint64_t dispatchNs) {
+        dispatchNs_ = dispatchNs_ == 0 ? dispatchNs : (dispatchNs_ * 7 + dispatchNs) / 8;
+
+        uint64_t batchNs = stats_->batchNs;
+        uint64_t batchTasks = stats_->batchTasks;
+        if(batchTasks == seenBatchTasks_) {
+            // 尚无新完成的批量任务
+            return;
+        }
+
+        // 单任务执行时间，至少按1ns计，避免空任务导致除零
+        double taskNs = std::max(1.0, static_cast<double>(batchNs - seenBatchNs_) / (batchTasks - seenBatchTasks_));
+        seenBatchNs_ = batchNs;
+        seenBatchTasks_ = batchTasks;
+        taskNs_ = taskNs_ == 0 ? taskNs : (taskNs_ * 7 + taskNs) / 8;
+
+        double target = std::max<double>(dispatchNs_, 1) * OVERHEAD_RATIO / taskNs_;
+        double limit = std::chrono::duration<double, std::nano>(options_.maxBatchTime).count() / taskNs_;
+        target = std::min({ target, limit, static_cast<double>(options_.maxBatchSize) });
+        batchSize_ = std::max<size_t>(static_cast<size_t>(target), 1);
+    }
+
+    template<typename Duration>
+    static uint64_t toNs(Duration duration) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
+private:
+    CoalesceOptions options_;                   // 配置
+    BasicTaskGroup<Pool> group_;                // 已提交的批量任务
+    std::shared_ptr<BatchStats> stats_;         // 批量任务的执行时间统计
+    std::vector<Task> buffer_;                  // 尚未提交的任务
+    Clock::time_point firstPostTime_;           // 缓冲区中最早任务的缓冲时间
+    size_t batchSize_;                          // 当前批量大小
+
+    //// 自适应调整（仅由生产者线程读写）
+    double dispatchNs_;                         // 提交开销的滑动平均
+    double taskNs_;                             // 单任务执行时间的滑动平均
+    uint64_t seenBatchNs_;                      // 上次调整时的批量执行总时间
+    uint64_t seenBatchTasks_;                   // 上次调整时的批量任务数量
+};
+
+// 默认策略线程池的合并提交器
+using TaskCoalescer = BasicTaskCoalescer<>;
+
+#endif
@@ -0,0 +1,268 @@
+#ifndef __COMPLETIONQUEUE_H__
+#define __COMPLETIONQUEUE_H__
+
+#include <deque>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+#include <exception>
+#include <type_traits>
+
+#include "threadpoolOpt.h"
+
+// 完成队列的结果顺序
+enum class CompletionOrder {
+    ORDER_COMPLETION,       // 按完成顺序返回结果
+    ORDER_SUBMISSION        // 按提交顺序返回结果
+};
+
+// 任务结果的完成队列
+/*
+    - 任务完成时由工作线程直接将结果写入队列，消费者通过next()按完成顺序（或提交顺序）取结果，
+      不需要逐个轮询future，先完成的结果不会被排在前面的慢任务挡住
+    - capacity限制已提交但尚未被取走的结果数量，达到上限时submit()阻塞，结果缓冲区因此有界；
+      工作线程写入结果时从不阻塞
+    - 任务抛出的异常在取到该结果时由next()/nextBatch()重新抛出
+    - 在工作线程中阻塞时协助执行线程池中的任务
+    - 被线程池拒绝的任务以拒绝的异常（如TaskRejectedError）作为其结果，同样由next()/nextBatch()重新抛出
+    - 析构函数等待已提交的任务全部完成，任务可以安全地引用调用方栈上的数据
+    - Pool为线程池类型，默认为ThreadPool，可为任意策略组合的BasicThreadPool
+
+    使用示例：
+        CompletionQueue<Response> queue(pool);
+        for(auto& request : requests) {
+            queue.submit(fetch, request);
+        }
+        while(auto response = queue.next()) {
+            handle(*response);
+        }
+*/
+template<typename T, typename Pool = ThreadPool>
+class CompletionQueue
+{
+    static_assert(!std::is_void_v<T>, "CompletionQueue requires a non-void result type");
+
+public:
+    // 构造函数，capacity为0表示不限制
+    explicit CompletionQueue(Pool& pool, CompletionOrder order = CompletionOrder::ORDER_COMPLETION, size_t capacity = 0)
+        : pool_(pool)
+        , state_(std::make_shared<State>(order))
+        , order_(order)
+        , capacity_(capacity)
+        , nextSubmitSeq_(0)
+        , nextConsumeSeq_(0)
+    {}
+
+    // 析构函数，等待已提交的任务全部完成
+    ~CompletionQueue() {
+        std::unique_lock<std::mutex> lock(state_->mtx_);
+        waitUntil(lock, [&]()->bool{
+            return state_->running_ == 0;
+        });
+    }
+
+    // 禁止对完成队列进行拷贝构造/赋值
+    CompletionQueue(const CompletionQueue&) = delete;
+    CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+    // 提交任务，未取走的结果达到capacity时阻塞
+    template<typename taskFunc, typename... Args>
+    void submit(taskFunc&& func, Args&&... args) {
+        static_assert(std::is_convertible_v<decltype(func(args...)), T>, "task result must be convertible to T");
+
+        size_t seq;
+        {
+            std::unique_lock<std::mutex> lock(state_->mtx_);
+            if(capacity_ > 0) {
+                waitUntil(lock, [&]()->bool{
+                    return pendingLocked() < capacity_;
+                });
+            }
+            seq = nextSubmitSeq_++;
+            state_->running_++;
+        }
+
+        // 任务持有共享状态，结果直接写入就绪队列
+        std::shared_ptr<State> state = state_;
+        auto result = std::make_shared<TaskFuture<void>>(pool_.submitTask(
+            [state, seq, task = std::bind(std::forward<taskFunc>(func), std::forward<Args>(args)...)]() mutable {
+                Entry entry;
+                try {
+                    entry.value.emplace(task());
+                }
+                catch(...) {
+                    entry.error = std::current_exception();
+                }
+                state->complete(seq, std::move(entry));
+            }
+        ));
+
+        // 任务自身的异常已写入结果，future中只会有线程池拒绝任务的异常，以其作为该任务的结果
+        result->onComplete([state, seq, result]() {
+            try {
+                result->get();
+            }
+            catch(...) {
+                Entry entry;
+                entry.error = std::current_exception();
+                state->complete(seq, std::move(entry));
+            }
+        });
+    }
+
+    // 取下一个结果，尚未完成时阻塞；所有已提交的结果均已取走时返回std::nullopt
+    std::optional<T> next() {
+        std::unique_lock<std::mutex> lock(state_->mtx_);
+        waitUntil(lock, [&]()->bool{
+            return hasReady() || pendingLocked() == 0;
+        });
+
+        if(!hasReady()) {
+            return std::nullopt;
+        }
+        return take(lock);
+    }
+
+    // 取下一个已完成的结果，不阻塞，没有已完成的结果时返回std::nullopt
+    std::optional<T> tryNext() {
+        std::unique_lock<std::mutex> lock(state_->mtx_);
+        if(!hasReady()) {
+            return std::nullopt;
+        }
+        return take(lock);
+    }
+
+    // 批量取结果：阻塞到至少有一个结果完成，再取走最多maxCount个已完成的结果
+    // 所有已提交的结果均已取走时返回空；遇到抛出异常的任务时，若批量中已有结果则先返回，否则重新抛出该异常
+    std::vector<T> nextBatch(size_t maxCount) {
+        std::vector<T> batch;
+        std::unique_lock<std::mutex> lock(state_->mtx_);
+        waitUntil(lock, [&]()->bool{
+            return hasReady() || pendingLocked() == 0;
+        });
+
+        while(batch.size() < maxCount && hasReady()) {
+            if(frontEntry().error && !batch.empty()) {
+                break;
+            }
+            batch.emplace_back(take(lock));
+        }
+        return batch;
+    }
+
+    // 已提交但尚未取走的结果数量
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(state_->mtx_);
+        return pendingLocked();
+    }
+
+private:
+    // 任务结果
+    struct Entry
+    {
+        std::optional<T> value;         // 返回值
+        std::exception_ptr error;       // 任务抛出的异常
+    };
+
+    // 完成队列共享状态
+    struct State
+    {
+        explicit State(CompletionOrder order)
+            : order_(order)
+        {}
+
+        // 工作线程写入结果
+        void complete(size_t seq, Entry&& entry) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if(order_ == CompletionOrder::ORDER_COMPLETION) {
+                completed_.emplace_back(std::move(entry));
+            }
+            else {
+                reordered_.emplace(seq, std::move(entry));
+            }
+            running_--;
+            readyCond_.notify_all();
+        }
+
+        CompletionOrder order_;                 // 结果顺序
+        std::deque<Entry> completed_;           // 已完成、尚未取走的结果，按完成顺序
+        std::map<size_t, Entry> reordered_;     // 已完成、尚未取走的结果，按提交序号排序
+        size_t running_ = 0;                    // 已提交、尚未完成的任务数量
+        std::mutex mtx_;                        // 保证结果队列的线程安全
+        std::condition_variable readyCond_;     // 有新结果完成，或有结果被取走
+    };
+
+    // 判断是否有可取的结果，调用时需持有mtx_
+    bool hasReady() const {
+        if(order_ == CompletionOrder::ORDER_COMPLETION) {
+            return !state_->completed_.empty();
+        }
+        return !state_->reordered_.empty() && state_->reordered_.begin()->first == nextConsumeSeq_;
+    }
+
+    // 下一个可取的结果，调用时需持有mtx_且hasReady()为true
+    Entry& frontEntry() {
+        if(order_ == CompletionOrder::ORDER_COMPLETION) {
+            return state_->completed_.front();
+        }
+        return state_->reordered_.begin()->second;
+    }
+
+    // 取走下一个结果，任务抛出的异常在此重新抛出，调用时需持有mtx_且hasReady()为true
+    T take(std::unique_lock<std::mutex>& lock) {
+        Entry entry = std::move(frontEntry());
+        if(order_ == CompletionOrder::ORDER_COMPLETION) {
+            state_->completed_.pop_front();
+        }
+        else {
+            state_->reordered_.erase(state_->reordered_.begin());
+        }
+        nextConsumeSeq_++;
+
+        // 通知等待容量的提交者
+        state_->readyCond_.notify_all();
+
+        if(entry.error) {
+            lock.unlock();
+            std::rethrow_exception(entry.error);
+        }
+        return std::move(*entry.value);
+    }
+
+    // 已提交但尚未取走的结果数量，调用时需持有mtx_
+    size_t pendingLocked() const {
+        return nextSubmitSeq_ - nextConsumeSeq_;
+    }
+
+    // 等待条件成立，工作线程中协助执行线程池任务，调用时需持有mtx_
+    template<typename Pred>
+    void waitUntil(std::unique_lock<std::mutex>& lock, Pred pred) {
+        bool inPoolThread = pool_.isInPoolThread();
+        while(!pred()) {
+            if(inPoolThread) {
+                lock.unlock();
+                bool ran = pool_.runPendingTask();
+                lock.lock();
+                // 释放锁期间条件可能已成立，其通知已错过，等待前需重新检查
+                if(ran || pred()) {
+                    continue;
+                }
+            }
+            state_->readyCond_.wait(lock);
+        }
+    }
+
+private:
+    Pool& pool_;                        // 执行任务的线程池
+    std::shared_ptr<State> state_;      // 完成队列共享状态
+    CompletionOrder order_;             // 结果顺序
+    size_t capacity_;                   // 未取走结果数量的上限，0表示不限制
+    size_t nextSubmitSeq_;              // 下一个提交的序号，在mtx_保护下读写
+    size_t nextConsumeSeq_;             // 下一个取走的序号，在mtx_保护下读写
+};
+
+#endif
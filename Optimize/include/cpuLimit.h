@@ -0,0 +1,40 @@
+#ifndef __CPULIMIT_H__
+#define __CPULIMIT_H__
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sched.h>
+
+// 当前进程可用的CPU数量
+/*
+    - 取CPU亲和性掩码（sched_getaffinity，受taskset/cpuset限制）中的CPU数量
+    - 以及cgroup v2的CPU配额（/sys/fs/cgroup/cpu.max，格式为"配额 周期"或"max 周期"）向上取整后的数量
+    - 两者中的较小值，至少为1；均无法获取时退化为hardware_concurrency()
+*/
+inline size_t detectCpuLimit(const std::string& cpuMaxPath = "/sys/fs/cgroup/cpu.max") {
+    size_t limit = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    // CPU亲和性
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0, sizeof(set), &set) == 0) {
+        limit = std::max(CPU_COUNT(&set), 1);
+    }
+
+    // cgroup v2 CPU配额，"max"表示不限制
+    std::ifstream file(cpuMaxPath);
+    std::string quota;
+    double period = 0;
+    if(file >> quota >> period && quota != "max" && period > 0) {
+        double cpus = std::ceil(std::strtod(quota.c_str(), nullptr) / period);
+        limit = std::min(limit, std::max<size_t>(static_cast<size_t>(cpus), 1));
+    }
+
+    return limit;
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef __FAIRSCHEDULER_H__
+#define __FAIRSCHEDULER_H__
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+
+#include "threadpoolOpt.h"
+#include "histogram.h"
+
+// 单个租户的统计快照
+struct TenantStats
+{
+    std::string name;               // 租户名称
+    unsigned weight;                // 权重
+    size_t maxConcurrency;          // 并发上限，0表示不限制
+    size_t queued;                  // 排队中的任务数量
+    size_t running;                 // 执行中的任务数量
+    uint64_t executed;              // 已执行的任务数量
+    HistogramSnapshot waitTime;     // 提交到开始执行的等待时间
+};
+
+// 多租户加权公平调度器
+/*
+    - 每个租户拥有独立的任务队列，任务先进入租户队列，而不是直接进入线程池的FIFO任务队列，
+      单个租户提交再多的任务也只会在自己的队列中排队
+    - 同时在线程池中运行的调度任务不超过maxInFlight个，每个调度任务按加权差额轮询（DRR）
+      从各租户队列中取任务执行，执行完后继续取下一个，没有可执行的任务时退出
+    - 每一轮中租户最多连续执行weight个任务，空队列的租户不累积额度；
+      设置了maxConcurrency的租户，执行中的任务达到上限后本轮跳过
+    - 线程池拒绝调度任务时撤销该调度任务，此时没有其它调度任务在运行，
+      则排队中的任务无人调度，以线程池拒绝的异常（如TaskRejectedError）结束，调用方从future中获取
+    - Pool为线程池类型，可为任意策略组合的BasicThreadPool，FairScheduler为默认线程池的别名
+
+    使用示例：
+        FairScheduler scheduler(pool);
+        auto search = scheduler.addTenant("search", 4);
+        auto batch = scheduler.addTenant("batch", 1, 2);
+        auto result = scheduler.submit(search, func, args...);
+*/
+template<typename Pool = ThreadPool>
+class BasicFairScheduler
+{
+public:
+    using TenantId = size_t;
+
+    // 构造函数，maxInFlight为同时在线程池中运行的调度任务数量，一般取线程池的线程数量
+    explicit BasicFairScheduler(Pool& pool, size_t maxInFlight = std::thread::hardware_concurrency())
+        : pool_(pool)
+        , maxInFlight_(std::max<size_t>(maxInFlight, 1))
+        , inFlight_(0)
+        , cursor_(0)
+    {}
+
+    // 析构函数，等待已提交的任务全部完成
+    ~BasicFairScheduler() {
+        wait();
+    }
+
+    // 禁止对调度器进行拷贝构造/赋值
+    BasicFairScheduler(const BasicFairScheduler&) = delete;
+    BasicFairScheduler& operator=(const BasicFairScheduler&) = delete;
+
+    // 添加租户，weight为每轮最多连续执行的任务数量，maxConcurrency为执行中任务数量的上限，0表示不限制
+    TenantId addTenant(const std::string& name, unsigned weight = 1, size_t maxConcurrency = 0) {
+        auto tenant = std::make_unique<Tenant>();
+        tenant->name = name;
+        tenant->weight = std::max(weight, 1u);
+        tenant->maxConcurrency = maxConcurrency;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        tenants_.emplace_back(std::move(tenant));
+        return tenants_.size() - 1;
+    }
+
+    // 以租户身份提交任务
+    template<typename taskFunc, typename... Args>
+    auto submit(TenantId tenantId, taskFunc&& func, Args&&... args) -> std::future<decltype(func(args...))> {
+        using retType = decltype(func(args...));
+
+        // 任务被拒绝时以拒绝的异常结束，不执行用户函数
+        auto task = std::make_shared<std::packaged_task<retType(std::exception_ptr)>>(
+            [bound = std::bind(std::forward<taskFunc>(func), std::forward<Args>(args)...)](std::exception_ptr rejected) mutable -> retType {
+                if(rejected) {
+                    std::rethrow_exception(rejected);
+                }
+                return bound();
+            }
+        );
+        std::future<retType> result = task->get_future();
+
+        bool startSlot = false;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if(tenantId >= tenants_.size()) {
+                throw std::out_of_range("FairScheduler: unknown tenant");
+            }
+
+            tenants_[tenantId]->queue.emplace_back(Item{
+                [task](std::exception_ptr rejected) { (*task)(rejected); },
+                Clock::now()
+            });
+
+            // 调度任务数量未达上限时，启动一个新的调度任务
+            if(inFlight_ < maxInFlight_) {
+                inFlight_++;
+                startSlot = true;
+            }
+        }
+
+        if(startSlot) {
+            // 调度任务被线程池拒绝时，从其future中取出拒绝的异常
+            auto slot = std::make_shared<TaskFuture<void>>(pool_.submitTask([this]() {
+                runSlot();
+            }));
+            slot->onComplete([this, slot]() {
+                try {
+                    slot->get();
+                }
+                catch(...) {
+                    onSlotRejected(std::current_exception());
+                }
+            });
+        }
+        return result;
+    }
+
+    // 等待已提交的任务全部完成，工作线程中调用时协助执行线程池任务
+    void wait() {
+        bool inPoolThread = pool_.isInPoolThread();
+        std::unique_lock<std::mutex> lock(mtx_);
+        while(inFlight_ > 0) {
+            if(inPoolThread) {
+                lock.unlock();
+                bool ran = pool_.runPendingTask();
+                lock.lock();
+                if(ran) {
+                    continue;
+                }
+            }
+            // 释放锁协助执行任务期间调度任务可能已全部退出，等待前需重新检查
+            idleCond_.wait(lock, [this]()->bool{
+                return inFlight_ == 0;
+            });
+        }
+    }
+
+    // 获取各租户的统计快照
+    std::vector<TenantStats> stats() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::vector<TenantStats> result;
+        result.reserve(tenants_.size());
+        for(auto& tenant : tenants_) {
+            TenantStats stats;
+            stats.name = tenant->name;
+            stats.weight = tenant->weight;
+            stats.maxConcurrency = tenant->maxConcurrency;
+            stats.queued = tenant->queue.size();
+            stats.running = tenant->running;
+            stats.executed = tenant->executed;
+            tenant->waitTime.addTo(stats.waitTime.buckets, stats.waitTime.sum);
+            for(uint64_t v : stats.waitTime.buckets) {
+                stats.waitTime.count += v;
+            }
+            result.emplace_back(std::move(stats));
+        }
+        return result;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // 租户队列中的任务
+    struct Item
+    {
+        std::function<void(std::exception_ptr)> task;   // 任务，参数非空时以该异常结束
+        Clock::time_point enqueueTime;      // 提交时间
+    };
+
+    // 租户
+    struct Tenant
+    {
+        std::string name;                   // 名称
+        unsigned weight = 1;                // 权重
+        size_t maxConcurrency = 0;          // 执行中任务数量的上限，0表示不限制
+        std::deque<Item> queue;             // 任务队列
+        unsigned deficit = 0;               // 本轮剩余的执行额度
+        size_t running = 0;                 // 执行中的任务数量
+        uint64_t executed = 0;              // 已执行的任务数量
+        LogHistogram waitTime;              // 等待时间直方图
+    };
+
+    // 调度任务，在线程池中不断按DRR取任务执行，没有可执行的任务时退出
+    void runSlot() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        for(;;) {
+            Item item;
+            Tenant* tenant = pickNext(item);
+            if(tenant == nullptr) {
+                // 剩余任务所属的租户均已达并发上限，由其执行中的调度任务继续调度
+                inFlight_--;
+                if(inFlight_ == 0) {
+                    idleCond_.notify_all();
+                }
+                return;
+            }
+            lock.unlock();
+
+            auto beginTime = Clock::now();
+            tenant->waitTime.record(std::chrono::duration_cast<std::chrono::nanoseconds>(beginTime - item.enqueueTime).count());
+            item.task(nullptr);
+
+            lock.lock();
+            tenant->running--;
+            tenant->executed++;
+        }
+    }
+
+    // 调度任务被线程池拒绝，撤销该调度任务
+    // 没有其它调度任务在运行时，排队中的任务无人调度，以拒绝的异常结束
+    void onSlotRejected(std::exception_ptr rejected) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if(inFlight_ > 1) {
+            // 仍在运行的调度任务退出前会再次检查租户队列
+            inFlight_--;
+            return;
+        }
+
+        // 结束排队中的任务前保留调度任务计数，避免wait()提前返回；期间新提交的任务同样无人调度
+        for(;;) {
+            std::vector<Item> orphans;
+            for(auto& tenant : tenants_) {
+                for(auto& item : tenant->queue) {
+                    orphans.emplace_back(std::move(item));
+                }
+                tenant->queue.clear();
+                tenant->deficit = 0;
+            }
+            if(orphans.empty()) {
+                break;
+            }
+
+            // 释放锁后再结束任务，future的等待者可能再次提交任务
+            lock.unlock();
+            for(auto& item : orphans) {
+                item.task(rejected);
+            }
+            lock.lock();
+        }
+
+        inFlight_--;
+        idleCond_.notify_all();
+    }
+
+    // 按加权差额轮询选择下一个任务，调用时需持有mtx_
+    Tenant* pickNext(Item& item) {
+        size_t size = tenants_.size();
+        for(size_t i = 0; i < size; ++i) {
+            size_t index = (cursor_ + i) % size;
+            Tenant& tenant = *tenants_[index];
+
+            // 空队列的租户不累积额度
+            if(tenant.queue.empty()) {
+                tenant.deficit = 0;
+                continue;
+            }
+
+            // 达到并发上限，本轮跳过
+            if(tenant.maxConcurrency > 0 && tenant.running >= tenant.maxConcurrency) {
+                continue;
+            }
+
+            // 轮到该租户时发放本轮额度
+            if(tenant.deficit == 0) {
+                tenant.deficit = tenant.weight;
+            }
+
+            item = std::move(tenant.queue.front());
+            tenant.queue.pop_front();
+            tenant.deficit--;
+            tenant.running++;
+
+            // 额度用完后轮到下一个租户
+            cursor_ = tenant.deficit == 0 ? (index + 1) % size : index;
+            return &tenant;
+        }
+        return nullptr;
+    }
+
+private:
+    Pool& pool_;                                        // 执行任务的线程池
+    size_t maxInFlight_;                                // 调度任务数量上限
+    size_t inFlight_;                                   // 线程池中的调度任务数量
+    size_t cursor_;                                     // 当前轮到的租户
+    std::vector<std::unique_ptr<Tenant>> tenants_;      // 租户
+    std::mutex mtx_;                                    // 保证租户队列的线程安全
+    std::condition_variable idleCond_;                  // 调度任务全部退出
+};
+
+// 默认策略线程池的公平调度器
+using FairScheduler = BasicFairScheduler<>;
+
+#endif
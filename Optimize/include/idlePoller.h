@@ -0,0 +1,23 @@
+#ifndef __IDLEPOLLER_H__
+#define __IDLEPOLLER_H__
+
+// 空闲轮询器接口，使I/O事件源与线程池共享工作线程
+/*
+    - 工作线程在任务队列为空时，若存在未被占用的轮询器，则阻塞在该轮询器上等待I/O事件，
+      事件的回调直接在该工作线程上执行，不再经过任务队列
+    - 每个轮询器同一时间最多由一个工作线程占用，其余空闲线程照常等待任务
+    - 有新任务而没有等待任务的空闲线程时，线程池调用wakeup()使轮询线程返回取任务
+*/
+class IdlePoller
+{
+public:
+    virtual ~IdlePoller() = default;
+
+    // 等待I/O事件并执行其回调，timeoutMs为最长等待时间（ms），返回是否处理了事件
+    virtual bool poll(int timeoutMs) = 0;
+
+    // 使正在poll()中阻塞的线程尽快返回，可在任意线程调用
+    virtual void wakeup() = 0;
+};
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef __PERFCOUNTER_H__
+#define __PERFCOUNTER_H__
+
+#include <string>
+#include <atomic>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "logger.h"
+
+// 硬件/软件性能计数器事件
+enum PerfEvent {
+    PERF_CYCLES,                // CPU周期数
+    PERF_INSTRUCTIONS,          // 指令数
+    PERF_LLC_MISSES,            // 末级缓存未命中次数
+    PERF_CONTEXT_SWITCHES,      // 上下文切换次数
+    PERF_EVENT_COUNT
+};
+
+// 性能计数器事件名称
+inline const char* perfEventName(int event) {
+    switch(event) {
+        case PERF_CYCLES: {
+            return "cycles";
+        }
+        case PERF_INSTRUCTIONS: {
+            return "instructions";
+        }
+        case PERF_LLC_MISSES: {
+            return "llc_misses";
+        }
+        case PERF_CONTEXT_SWITCHES: {
+            return "context_switches";
+        }
+        default: {
+            return "unknown";
+        }
+    }
+}
+
+// 单个工作线程的性能计数器快照
+struct PerfSnapshot
+{
+    std::string threadName;                     // 线程名称
+    bool available[PERF_EVENT_COUNT];           // 各事件是否可用
+    uint64_t taskCounts[PERF_EVENT_COUNT];      // 执行任务期间的计数
+    uint64_t idleCounts[PERF_EVENT_COUNT];      // 空闲/等待任务队列期间的计数
+    uint64_t taskCount;                         // 已执行的任务数量
+};
+
+// 单个工作线程的性能计数器累计值，工作线程写入，快照接口并发读取
+struct PerfRecord
+{
+    explicit PerfRecord(const std::string& name)
+        : threadName(name)
+    {
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            available[i] = false;
+            taskCounts[i] = 0;
+            idleCounts[i] = 0;
+        }
+    }
+
+    // 生成快照
+    PerfSnapshot snapshot() const {
+        PerfSnapshot snap;
+        snap.threadName = threadName;
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            snap.available[i] = available[i];
+            snap.taskCounts[i] = taskCounts[i].load(std::memory_order_relaxed);
+            snap.idleCounts[i] = idleCounts[i].load(std::memory_order_relaxed);
+        }
+        snap.taskCount = taskCount.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+    // 合并一个已退出线程的记录，某个事件在任一线程上可用即视为可用
+    void merge(const PerfRecord& other) {
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            available[i] = available[i] || other.available[i];
+            taskCounts[i].fetch_add(other.taskCounts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            idleCounts[i].fetch_add(other.idleCounts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        taskCount.fetch_add(other.taskCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    std::string threadName;                             // 线程名称
+    bool available[PERF_EVENT_COUNT];                   // 各事件是否可用，仅在记录发布前由探针构造函数写入，或持锁合并时写入
+    std::atomic<uint64_t> taskCounts[PERF_EVENT_COUNT]; // 执行任务期间的计数
+    std::atomic<uint64_t> idleCounts[PERF_EVENT_COUNT]; // 空闲期间的计数
+    std::atomic<uint64_t> taskCount{0};                 // 已执行的任务数量
+    std::atomic_bool exited{false};                     // 所属线程是否已退出，退出后计数不再变化
+};
+
+// 工作线程性能计数器探针，只能在所属的工作线程中使用
+/*
+    - 通过perf_event_open为调用线程打开计数器，每个事件独立打开，
+      虚拟机中不支持的硬件事件或perf_event_paranoid禁止的事件会被单独标记为不可用
+    - 优先统计用户态+内核态，权限不足时退化为仅统计用户态
+    - 任务开始与结束时各读取一次计数器，任务执行期间的增量计入task，其余计入idle
+*/
+class PerfProbe
+{
+public:
+    // 构造函数，为调用线程打开计数器
+    explicit PerfProbe(std::shared_ptr<PerfRecord> record)
+        : record_(std::move(record))
+    {
+        static const uint32_t types[PERF_EVENT_COUNT] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE
+        };
+        static const uint64_t configs[PERF_EVENT_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_SW_CONTEXT_SWITCHES
+        };
+
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            fds_[i] = openCounter(types[i], configs[i]);
+            record_->available[i] = fds_[i] >= 0;
+            last_[i] = 0;
+        }
+        readCounters(last_);
+    }
+
+    // 析构函数，关闭计数器，之后记录可被合并
+    ~PerfProbe() {
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            if(fds_[i] >= 0) {
+                close(fds_[i]);
+            }
+        }
+        record_->exited.store(true, std::memory_order_release);
+    }
+
+    // 禁止对探针进行拷贝构造/赋值
+    PerfProbe(const PerfProbe&) = delete;
+    PerfProbe& operator=(const PerfProbe&) = delete;
+
+    // 任务开始执行，上一次读取以来的增量计入idle
+    void taskBegin() {
+        accumulate(record_->idleCounts);
+    }
+
+    // 任务执行完毕，任务执行期间的增量计入task
+    void taskEnd() {
+        accumulate(record_->taskCounts);
+        record_->taskCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    // 打开单个计数器，失败时返回-1
+    static int openCounter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_hv = 1;
+
+        // pid = 0, cpu = -1：统计调用线程在任意CPU上的事件
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if(fd < 0 && (errno == EACCES || errno == EPERM)) {
+            // 权限不足，退化为仅统计用户态
+            attr.exclude_kernel = 1;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+
+        if(fd < 0) {
+            reportUnavailable(errno);
+        }
+        return fd;
+    }
+
+    // 计数器不可用时仅输出一次警告
+    static void reportUnavailable(int err) {
+        static std::atomic_bool reported(false);
+        if(reported.exchange(true)) {
+            return;
+        }
+
+        int paranoid = -1;
+        std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+        file >> paranoid;
+        LOG_WARN() << "perf_event_open failed: " << strerror(err)
+                   << ", perf_event_paranoid = " << paranoid
+                   << ", unavailable counters will be reported as disabled";
+    }
+
+    // 读取所有可用计数器的当前值
+    void readCounters(uint64_t (&values)[PERF_EVENT_COUNT]) {
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            uint64_t value = 0;
+            if(fds_[i] >= 0 && read(fds_[i], &value, sizeof(value)) == sizeof(value)) {
+                values[i] = value;
+            }
+        }
+    }
+
+    // 将上一次读取以来的增量累加到目标计数
+    void accumulate(std::atomic<uint64_t> (&counts)[PERF_EVENT_COUNT]) {
+        uint64_t now[PERF_EVENT_COUNT];
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            now[i] = last_[i];
+        }
+        readCounters(now);
+
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            counts[i].fetch_add(now[i] - last_[i], std::memory_order_relaxed);
+            last_[i] = now[i];
+        }
+    }
+
+private:
+    std::shared_ptr<PerfRecord> record_;    // 计数累计值
+    int fds_[PERF_EVENT_COUNT];             // 计数器文件描述符，-1表示不可用
+    uint64_t last_[PERF_EVENT_COUNT];       // 上一次读取的计数值
+};
+
+#endif
@@ -0,0 +1,409 @@
+#ifndef __PIPELINE_H__
+#define __PIPELINE_H__
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+#include <exception>
+
+#include "threadpoolOpt.h"
+
+// 流水线阶段类型
+enum class StageMode {
+    SERIAL_IN_ORDER,        // 串行，按输入顺序依次处理
+    SERIAL_OUT_OF_ORDER,    // 串行，不保证处理顺序
+    PARALLEL                // 并行，多个令牌可同时处理
+};
+
+// 基于线程池的多阶段有界流水线
+/*
+    - 每个数据项以令牌（token）的形式在流水线中流动，同时在途的令牌数量不超过maxTokens，
+      上游阶段跑得再快也不会无限堆积中间结果
+    - 令牌尽量在同一个工作线程上依次通过各个阶段，保持数据的缓存局部性；
+      只有在串行阶段被占用时才会暂存，由释放该阶段的线程重新提交到线程池
+    - 令牌完成最后一个阶段后，当前工作线程直接从输入阶段获取下一个数据项
+    - 线程池拒绝令牌的处理任务时，流水线停止输入，run()重新抛出拒绝的异常（如TaskRejectedError）
+    - Pool为线程池类型，可为任意策略组合的BasicThreadPool，Pipeline为默认线程池的别名
+
+    使用示例：
+        Pipeline pipeline(pool);
+        pipeline.setSource<Line>([&]() -> std::optional<Line> { ... })
+                .addStage<Line, Record>(StageMode::PARALLEL, parse)
+                .addStage<Record, Block>(StageMode::PARALLEL, compress)
+                .addStage<Block, void>(StageMode::SERIAL_IN_ORDER, write);
+        pipeline.run(16);
+*/
+template<typename Pool = ThreadPool>
+class BasicPipeline
+{
+public:
+    // 构造函数
+    explicit BasicPipeline(Pool& pool)
+        : pool_(pool)
+    {}
+
+    // 禁止对流水线进行拷贝构造/赋值
+    BasicPipeline(const BasicPipeline&) = delete;
+    BasicPipeline& operator=(const BasicPipeline&) = delete;
+
+    // 设置输入阶段，返回std::nullopt表示输入结束，输入阶段总是串行按序执行
+    template<typename Out, typename Func>
+    BasicPipeline& setSource(Func&& func) {
+        source_ = [func = std::forward<Func>(func)](Value& value) mutable -> bool {
+            std::optional<Out> item = func();
+            if(!item) {
+                return false;
+            }
+            value.template emplace<Out>(std::move(*item));
+            return true;
+        };
+        return *this;
+    }
+
+    // 追加处理阶段，In为上一阶段的输出类型，Out为void表示最后一个阶段
+    template<typename In, typename Out, typename Func>
+    BasicPipeline& addStage(StageMode mode, Func&& func) {
+        auto stage = std::make_unique<Stage>();
+        stage->mode_ = mode;
+        stage->func_ = [func = std::forward<Func>(func)](Value& value) mutable {
+            if constexpr (std::is_void_v<Out>) {
+                func(std::move(value.template get<In>()));
+                value.reset();
+            }
+            else {
+                value.template emplace<Out>(func(std::move(value.template get<In>())));
+            }
+        };
+        stages_.emplace_back(std::move(stage));
+        return *this;
+    }
+
+    // 运行流水线，阻塞直到所有输入处理完毕，若某个阶段抛出异常，则重新抛出第一个异常
+    void run(size_t maxTokens) {
+        if(maxTokens == 0) {
+            maxTokens = 1;
+        }
+
+        // 重置运行状态
+        sourceDone_ = false;
+        nextInputSeq_ = 0;
+        activeWorkers_ = maxTokens;
+        exception_ = nullptr;
+        for(auto& stage : stages_) {
+            stage->busy_ = false;
+            stage->nextSeq_ = 0;
+            stage->parkedInOrder_.clear();
+            stage->parkedOutOfOrder_.clear();
+        }
+
+        // 每个令牌对应一个在线程池中运行的处理任务
+        for(size_t i = 0; i < maxTokens; ++i) {
+            submitSlot(nullptr);
+        }
+
+        // 等待所有令牌退出，工作线程中调用时协助执行线程池任务
+        bool inPoolThread = pool_.isInPoolThread();
+        std::unique_lock<std::mutex> lock(doneMtx_);
+        while(activeWorkers_ > 0) {
+            if(inPoolThread) {
+                lock.unlock();
+                bool ran = pool_.runPendingTask();
+                lock.lock();
+                if(ran) {
+                    continue;
+                }
+            }
+            doneCond_.wait(lock, [&]()->bool{
+                return activeWorkers_ == 0;
+            });
+        }
+
+        if(exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    // 阶段之间传递的数据，类型擦除，支持仅可移动的类型
+    class Value
+    {
+    public:
+        template<typename T>
+        void emplace(T&& data) {
+            // 先构造新数据，再释放旧数据，新数据可能由旧数据移动而来
+            std::unique_ptr<Base> holder = std::make_unique<Holder<std::decay_t<T>>>(std::forward<T>(data));
+            holder_ = std::move(holder);
+        }
+
+        template<typename T>
+        T& get() {
+            return static_cast<Holder<T>*>(holder_.get())->data_;
+        }
+
+        void reset() {
+            holder_.reset();
+        }
+
+    private:
+        struct Base
+        {
+            virtual ~Base() = default;
+        };
+
+        template<typename T>
+        struct Holder : Base
+        {
+            template<typename U>
+            explicit Holder(U&& data) : data_(std::forward<U>(data)) {}
+            T data_;
+        };
+
+        std::unique_ptr<Base> holder_;
+    };
+
+    // 令牌
+    struct Token
+    {
+        size_t seq_;            // 输入序号
+        size_t stage_;          // 下一个待执行的阶段
+        bool cancelled_;        // 处理过程中出现异常，跳过后续阶段的处理函数
+        Value value_;           // 当前阶段的数据
+    };
+    using TokenPtr = std::shared_ptr<Token>;
+
+    // 阶段
+    struct Stage
+    {
+        StageMode mode_;                                // 阶段类型
+        std::function<void(Value&)> func_;              // 阶段处理函数
+        std::mutex mtx_;                                // 保证串行阶段状态的线程安全
+        bool busy_ = false;                             // 串行阶段是否被占用
+        size_t nextSeq_ = 0;                            // 按序阶段下一个允许进入的序号
+        std::map<size_t, TokenPtr> parkedInOrder_;      // 按序阶段中等待的令牌
+        std::deque<TokenPtr> parkedOutOfOrder_;         // 乱序阶段中等待的令牌
+    };
+
+    // 令牌处理循环，token为空时从输入阶段获取新的令牌
+    void processTokens(TokenPtr token) {
+        for(;;) {
+            if(token == nullptr) {
+                token = fetchToken();
+                if(token == nullptr) {
+                    // 输入结束，当前令牌槽位退出
+                    std::lock_guard<std::mutex> lock(doneMtx_);
+                    if(--activeWorkers_ == 0) {
+                        doneCond_.notify_all();
+                    }
+                    return;
+                }
+            }
+
+            // 令牌在当前线程上依次通过各个阶段
+            while(token->stage_ < stages_.size()) {
+                Stage& stage = *stages_[token->stage_];
+
+                if(stage.mode_ == StageMode::PARALLEL) {
+                    execStage(stage, *token);
+                    token->stage_++;
+                    continue;
+                }
+
+                // 串行阶段被占用或未轮到当前序号，暂存令牌，释放当前工作线程
+                if(!enterSerialStage(stage, token)) {
+                    return;
+                }
+
+                execStage(stage, *token);
+                token->stage_++;
+                leaveSerialStage(stage);
+            }
+
+            // 令牌处理完毕，复用当前线程获取下一个输入
+            token.reset();
+        }
+    }
+
+    // 从输入阶段获取令牌，输入结束或出现异常时返回空
+    TokenPtr fetchToken() {
+        std::lock_guard<std::mutex> lock(sourceMtx_);
+        if(sourceDone_) {
+            return nullptr;
+        }
+
+        auto token = std::make_shared<Token>();
+        bool hasItem = false;
+        try {
+            hasItem = source_(token->value_);
+        }
+        catch(...) {
+            setException(std::current_exception());
+        }
+
+        if(!hasItem) {
+            sourceDone_ = true;
+            return nullptr;
+        }
+
+        token->seq_ = nextInputSeq_++;
+        token->stage_ = 0;
+        token->cancelled_ = false;
+        return token;
+    }
+
+    // 执行阶段处理函数，出现异常时取消该令牌并停止输入
+    void execStage(Stage& stage, Token& token) {
+        if(token.cancelled_) {
+            return;
+        }
+
+        try {
+            stage.func_(token.value_);
+        }
+        catch(...) {
+            token.cancelled_ = true;
+            token.value_.reset();
+            setException(std::current_exception());
+
+            std::lock_guard<std::mutex> lock(sourceMtx_);
+            sourceDone_ = true;
+        }
+    }
+
+    // 尝试进入串行阶段，无法进入时转移令牌的所有权并返回false
+    bool enterSerialStage(Stage& stage, TokenPtr& token) {
+        std::lock_guard<std::mutex> lock(stage.mtx_);
+        if(stage.mode_ == StageMode::SERIAL_IN_ORDER) {
+            if(stage.busy_ || token->seq_ != stage.nextSeq_) {
+                size_t seq = token->seq_;
+                stage.parkedInOrder_.emplace(seq, std::move(token));
+                return false;
+            }
+        }
+        else if(stage.busy_) {
+            stage.parkedOutOfOrder_.emplace_back(std::move(token));
+            return false;
+        }
+
+        stage.busy_ = true;
+        return true;
+    }
+
+    // 离开串行阶段，唤醒一个可以进入该阶段的暂存令牌
+    void leaveSerialStage(Stage& stage) {
+        TokenPtr next;
+        {
+            std::lock_guard<std::mutex> lock(stage.mtx_);
+            stage.busy_ = false;
+
+            if(stage.mode_ == StageMode::SERIAL_IN_ORDER) {
+                stage.nextSeq_++;
+                auto it = stage.parkedInOrder_.find(stage.nextSeq_);
+                if(it != stage.parkedInOrder_.end()) {
+                    next = std::move(it->second);
+                    stage.parkedInOrder_.erase(it);
+                }
+            }
+            else if(!stage.parkedOutOfOrder_.empty()) {
+                next = std::move(stage.parkedOutOfOrder_.front());
+                stage.parkedOutOfOrder_.pop_front();
+            }
+
+            // 提前占用该阶段，保证被唤醒的令牌一定能够进入
+            if(next != nullptr) {
+                stage.busy_ = true;
+            }
+        }
+
+        if(next != nullptr) {
+            // 被唤醒的令牌已经占用该阶段，直接从该阶段开始继续处理
+            submitSlot(std::move(next));
+        }
+    }
+
+    // 向线程池提交令牌槽位的处理任务，token为空时从输入阶段获取新的令牌，否则继续处理该暂存令牌
+    void submitSlot(TokenPtr token) {
+        auto result = std::make_shared<TaskFuture<void>>(pool_.submitTask([this, token]() {
+            if(token != nullptr) {
+                resumeToken(token);
+            }
+            else {
+                processTokens(nullptr);
+            }
+        }));
+
+        // 处理任务不抛出异常，future中只会有线程池拒绝任务的异常
+        result->onComplete([this, token, result]() {
+            try {
+                result->get();
+            }
+            catch(...) {
+                onSlotRejected(token, std::current_exception());
+            }
+        });
+    }
+
+    // 令牌槽位的处理任务被线程池拒绝：记录异常并停止输入
+    // 暂存令牌已占用其串行阶段，取消后在当前线程上跳过剩余阶段，释放各阶段并唤醒其后的令牌，槽位随后正常退出；
+    // 新令牌的槽位直接退出
+    void onSlotRejected(TokenPtr token, std::exception_ptr rejected) {
+        setException(rejected);
+        {
+            std::lock_guard<std::mutex> lock(sourceMtx_);
+            sourceDone_ = true;
+        }
+
+        if(token != nullptr) {
+            token->cancelled_ = true;
+            token->value_.reset();
+            resumeToken(std::move(token));
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(doneMtx_);
+        if(--activeWorkers_ == 0) {
+            doneCond_.notify_all();
+        }
+    }
+
+    // 继续处理一个已占用当前串行阶段的令牌
+    void resumeToken(TokenPtr token) {
+        Stage& stage = *stages_[token->stage_];
+        execStage(stage, *token);
+        token->stage_++;
+        leaveSerialStage(stage);
+        processTokens(std::move(token));
+    }
+
+    // 记录第一个异常
+    void setException(std::exception_ptr exception) {
+        std::lock_guard<std::mutex> lock(doneMtx_);
+        if(!exception_) {
+            exception_ = exception;
+        }
+    }
+
+private:
+    Pool& pool_;                                        // 流水线所使用的线程池
+    std::function<bool(Value&)> source_;                // 输入阶段
+    std::vector<std::unique_ptr<Stage>> stages_;        // 处理阶段
+
+    std::mutex sourceMtx_;                              // 保证输入阶段串行执行
+    bool sourceDone_ = false;                           // 输入是否结束
+    size_t nextInputSeq_ = 0;                           // 下一个输入序号
+
+    std::mutex doneMtx_;                                // 保证完成状态的线程安全
+    std::condition_variable doneCond_;                  // 所有令牌退出
+    size_t activeWorkers_ = 0;                          // 仍在运行的令牌槽位数量
+    std::exception_ptr exception_;                      // 第一个异常
+};
+
+// 默认策略线程池的流水线
+using Pipeline = BasicPipeline<>;
+
+#endif
@@ -0,0 +1,444 @@
+#ifndef __POOLSTATS_H__
+#define __POOLSTATS_H__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+
+#include "histogram.h"
+
+// 单个工作线程的统计
+struct WorkerStats
+{
+    std::string threadName;         // 线程名称
+    uint64_t taskCount;             // 已执行的任务数量
+    double busyRatio;               // 执行任务的时间占线程存活时间的比例
+    bool exited;                    // 线程是否已退出
+};
+
+// 被看门狗标记的长时间运行任务
+struct LongTaskInfo
+{
+    std::string threadName;         // 执行该任务的线程名称
+    std::string label;              // 提交时指定的标签，未指定时为空
+    std::string file;               // 提交位置所在文件，未指定时为空
+    int line;                       // 提交位置所在行，未指定时为0
+    double runningMs;               // 已运行时间，单位：ms
+};
+
+// 线程池运行时统计快照
+struct PoolStats
+{
+    uint64_t enqueueCount;                  // 入队任务总数
+    uint64_t dequeueCount;                  // 出队任务总数
+    uint64_t queueDepth;                    // 当前任务队列中的任务数量
+    uint64_t queueBytes;                    // 当前任务队列占用的内存，单位：字节
+    uint64_t queueMaxBytes;                 // 任务队列占用内存的上限，0表示不限制
+    uint64_t curThreadSize;                 // 当前线程数量
+    uint64_t idleThreadSize;                // 当前空闲线程数量
+    uint64_t threadsSpawned;                // cached模式下动态创建的线程数量
+    uint64_t threadsReaped;                 // cached模式下超时回收的线程数量
+    uint64_t tasksRejected;                 // 任务队列已满时提交失败的任务数量
+    uint64_t tasksDropped;                  // 任务队列已满时被丢弃的最早任务数量
+    uint64_t tasksCallerRun;                // 任务队列已满时在提交线程上执行的任务数量
+    uint64_t tasksShed;                     // 准入控制拒绝的低优先级任务数量
+    bool shedding;                          // 准入控制当前是否正在拒绝低优先级任务
+    uint64_t longTasksFlagged;              // 被看门狗标记为长时间运行的任务总数
+    uint64_t compensateThreadSize;          // 当前为长时间运行任务补偿的临时线程数量
+    HistogramSnapshot queueWaitTime;        // 任务在队列中的等待时间
+    HistogramSnapshot execTime;             // 任务执行时间
+    std::vector<WorkerStats> workers;       // 各工作线程统计
+    std::vector<LongTaskInfo> longRunningTasks; // 当前仍在运行的被标记任务
+
+    // 以Prometheus文本格式输出，prefix为指标名前缀
+    std::string toPrometheus(const std::string& prefix = "threadpool") const {
+        std::ostringstream os;
+
+        auto counter = [&](const std::string& name, const char* help, uint64_t value) {
+            os << "# HELP " << prefix << "_" << name << " " << help << "\n";
+            os << "# TYPE " << prefix << "_" << name << " counter\n";
+            os << prefix << "_" << name << " " << value << "\n";
+        };
+        auto gauge = [&](const std::string& name, const char* help, uint64_t value) {
+            os << "# HELP " << prefix << "_" << name << " " << help << "\n";
+            os << "# TYPE " << prefix << "_" << name << " gauge\n";
+            os << prefix << "_" << name << " " << value << "\n";
+        };
+
+        counter("tasks_enqueued_total", "Tasks pushed into the task queue.", enqueueCount);
+        counter("tasks_dequeued_total", "Tasks taken from the task queue.", dequeueCount);
+        gauge("queue_depth", "Tasks currently waiting in the task queue.", queueDepth);
+        gauge("queue_bytes", "Memory held by tasks waiting in the task queue.", queueBytes);
+        gauge("queue_max_bytes", "Memory budget of the task queue, 0 if unlimited.", queueMaxBytes);
+        gauge("threads", "Current number of worker threads.", curThreadSize);
+        gauge("idle_threads", "Current number of idle worker threads.", idleThreadSize);
+        counter("threads_spawned_total", "Worker threads spawned on demand in cached mode.", threadsSpawned);
+        counter("threads_reaped_total", "Idle worker threads reaped in cached mode.", threadsReaped);
+        counter("tasks_rejected_total", "Tasks rejected because the task queue was full.", tasksRejected);
+        counter("tasks_dropped_total", "Queued tasks dropped to admit newer tasks.", tasksDropped);
+        counter("tasks_caller_run_total", "Tasks run on the submitting thread because the task queue was full.", tasksCallerRun);
+        counter("tasks_shed_total", "Low priority tasks shed by admission control.", tasksShed);
+        gauge("shedding", "Whether admission control is shedding low priority tasks.", shedding ? 1 : 0);
+        counter("long_tasks_flagged_total", "Tasks flagged by the watchdog as long running.", longTasksFlagged);
+        gauge("long_running_tasks", "Flagged tasks that are still running.", longRunningTasks.size());
+        gauge("compensate_threads", "Temporary workers added for long running tasks.", compensateThreadSize);
+
+        writeHistogram(os, prefix + "_queue_wait_seconds", "Time tasks spent waiting in the queue.", queueWaitTime);
+        writeHistogram(os, prefix + "_exec_seconds", "Task execution time.", execTime);
+
+        os << "# HELP " << prefix << "_worker_busy_ratio Fraction of lifetime spent executing tasks.\n";
+        os << "# TYPE " << prefix << "_worker_busy_ratio gauge\n";
+        for(auto& worker : workers) {
+            os << prefix << "_worker_busy_ratio{thread=\"" << worker.threadName << "\"} " << worker.busyRatio << "\n";
+        }
+
+        return os.str();
+    }
+
+private:
+    // 以2的幂为边界（1us ~ 68s）输出Prometheus直方图
+    static void writeHistogram(std::ostringstream& os, const std::string& name, const char* help,
+                               const HistogramSnapshot& hist) {
+        os << "# HELP " << name << " " << help << "\n";
+        os << "# TYPE " << name << " histogram\n";
+
+        uint64_t cumulative = 0;
+        int index = 0;
+        for(int shift = 10; shift <= 36; ++shift) {
+            uint64_t bound = uint64_t(1) << shift;
+            while(index < LogHistogram::BUCKET_COUNT && LogHistogram::bucketUpperBound(index) <= bound) {
+                cumulative += hist.buckets[index++];
+            }
+            os << name << "_bucket{le=\"" << bound / 1e9 << "\"} " << cumulative << "\n";
+        }
+        os << name << "_bucket{le=\"+Inf\"} " << hist.count << "\n";
+        os << name << "_sum " << hist.sum / 1e9 << "\n";
+        os << name << "_count " << hist.count << "\n";
+    }
+};
+
+// 线程池统计收集器
+/*
+    - 计数器与直方图按线程分片，每个分片按缓存行对齐，
+      生产者与工作线程各自写入自己的分片，避免统计本身成为竞争点
+    - 快照时汇总所有分片，快照与记录之间不加锁，结果为近似一致
+*/
+class PoolStatsCollector
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const int SHARD_COUNT = 16;
+    static const size_t MAX_WORKER_RECORDS = 1024;
+    static constexpr bool ENABLED = true;       // 作为线程池的统计策略时，表示开启统计
+
+    // 单个工作线程的统计记录
+    struct WorkerRecord
+    {
+        explicit WorkerRecord(const std::string& name)
+            : threadName(name)
+            , startTime(Clock::now())
+        {}
+
+        std::string threadName;                 // 线程名称
+        Clock::time_point startTime;            // 线程启动时间
+        std::atomic<int64_t> exitTime{0};       // 线程退出时间（相对启动时间，ns），0表示未退出
+        std::atomic<uint64_t> busyNs{0};        // 执行任务的总时间
+        std::atomic<uint64_t> taskCount{0};     // 已执行的任务数量
+
+        // 看门狗使用的当前任务状态，以runState作为序列号保证读取一致
+        /*
+            runState: 0表示未执行任务，否则为(任务序号 << 1) | 是否已被标记
+        */
+        std::atomic<uint64_t> runState{0};      // 当前任务状态
+        std::atomic<int64_t> taskBegin{0};      // 当前任务开始时间（steady_clock，ns）
+        std::atomic<const char*> siteLabel{nullptr};    // 当前任务的提交标签
+        std::atomic<const char*> siteFile{nullptr};     // 当前任务的提交文件
+        std::atomic<int> siteLine{0};                   // 当前任务的提交行号
+        uint64_t taskSeq = 0;                   // 任务序号，仅由所属工作线程读写
+    };
+
+    // 记录任务入队
+    void onEnqueue() {
+        localShard().enqueueCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 记录任务出队，enqueueTime为任务入队时间
+    void onDequeue(Clock::time_point enqueueTime, Clock::time_point now) {
+        Shard& shard = localShard();
+        shard.dequeueCount.fetch_add(1, std::memory_order_relaxed);
+        shard.queueWait.record(toNs(now - enqueueTime));
+    }
+
+    // 记录任务执行时间
+    // nested为等待中协助执行的嵌套任务，其时间已包含在外层任务中，不计入线程的busyNs
+    void onExecuted(WorkerRecord* worker, Clock::time_point begin, Clock::time_point end, bool nested) {
+        uint64_t ns = toNs(end - begin);
+        localShard().execTime.record(ns);
+        if(worker != nullptr) {
+            if(!nested) {
+                worker->busyNs.fetch_add(ns, std::memory_order_relaxed);
+            }
+            worker->taskCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 记录cached模式下线程的创建与回收
+    void onThreadSpawned() {
+        threadsSpawned_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void onThreadReaped() {
+        threadsReaped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 记录任务队列已满时的溢出处理
+    void onRejected() {
+        tasksRejected_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void onDropped() {
+        tasksDropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void onCallerRuns() {
+        tasksCallerRun_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 记录准入控制拒绝的低优先级任务
+    void onShed() {
+        tasksShed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 记录任务开始执行，供看门狗检查执行时间
+    void onTaskBegin(WorkerRecord* worker, Clock::time_point begin,
+                     const char* label, const char* file, int line) {
+        // 先作废旧状态，再写入提交位置，最后发布新状态
+        worker->runState.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        worker->siteLabel.store(label, std::memory_order_relaxed);
+        worker->siteFile.store(file, std::memory_order_relaxed);
+        worker->siteLine.store(line, std::memory_order_relaxed);
+        worker->taskBegin.store(begin.time_since_epoch().count(), std::memory_order_relaxed);
+        worker->runState.store(++worker->taskSeq << 1, std::memory_order_release);
+    }
+
+    // 记录任务执行结束，返回该任务是否已被看门狗标记
+    bool onTaskEnd(WorkerRecord* worker) {
+        return worker->runState.exchange(0, std::memory_order_acq_rel) & 1;
+    }
+
+    // 标记执行时间超过threshold的任务，返回本次新标记的数量
+    // flaggedRunning在标记前加1，保证工作线程结束任务时的减1总在其后；标记失败（任务恰好结束）时撤销
+    template<typename OnFlagged>
+    size_t flagLongTasks(Clock::time_point now, Clock::duration threshold,
+                         std::atomic_int& flaggedRunning, OnFlagged onFlagged) {
+        size_t flagged = 0;
+        std::lock_guard<std::mutex> lock(workerMtx_);
+        for(auto& record : workers_) {
+            uint64_t state = record->runState.load(std::memory_order_acquire);
+            if(state == 0 || (state & 1)) {
+                continue;
+            }
+
+            Clock::time_point begin(Clock::duration(record->taskBegin.load(std::memory_order_relaxed)));
+            if(now - begin < threshold) {
+                continue;
+            }
+
+            flaggedRunning++;
+            if(!record->runState.compare_exchange_strong(state, state | 1, std::memory_order_acq_rel)) {
+                flaggedRunning--;
+                continue;
+            }
+            longTasksFlagged_.fetch_add(1, std::memory_order_relaxed);
+            onFlagged(*record);
+            ++flagged;
+        }
+        return flagged;
+    }
+
+    // 注册工作线程，记录过多时清理已退出线程的记录，避免cached模式下无限增长
+    std::shared_ptr<WorkerRecord> registerWorker(const std::string& name) {
+        auto record = std::make_shared<WorkerRecord>(name);
+        std::lock_guard<std::mutex> lock(workerMtx_);
+        if(workers_.size() >= MAX_WORKER_RECORDS) {
+            workers_.erase(std::remove_if(workers_.begin(), workers_.end(), [](const std::shared_ptr<WorkerRecord>& r) {
+                return r->exitTime != 0;
+            }), workers_.end());
+        }
+        workers_.emplace_back(record);
+        return record;
+    }
+
+    // 工作线程退出
+    void onWorkerExit(WorkerRecord* worker) {
+        if(worker != nullptr) {
+            worker->exitTime = std::max<int64_t>(toNs(Clock::now() - worker->startTime), 1);
+        }
+    }
+
+    // 汇总所有分片，生成快照中由收集器维护的部分
+    void fill(PoolStats& stats) {
+        stats.enqueueCount = 0;
+        stats.dequeueCount = 0;
+        for(auto& shard : shards_) {
+            stats.enqueueCount += shard.enqueueCount.load(std::memory_order_relaxed);
+            stats.dequeueCount += shard.dequeueCount.load(std::memory_order_relaxed);
+            shard.queueWait.addTo(stats.queueWaitTime.buckets, stats.queueWaitTime.sum);
+            shard.execTime.addTo(stats.execTime.buckets, stats.execTime.sum);
+        }
+        for(uint64_t v : stats.queueWaitTime.buckets) {
+            stats.queueWaitTime.count += v;
+        }
+        for(uint64_t v : stats.execTime.buckets) {
+            stats.execTime.count += v;
+        }
+
+        stats.threadsSpawned = threadsSpawned_.load(std::memory_order_relaxed);
+        stats.threadsReaped = threadsReaped_.load(std::memory_order_relaxed);
+        stats.longTasksFlagged = longTasksFlagged_.load(std::memory_order_relaxed);
+        stats.tasksRejected = tasksRejected_.load(std::memory_order_relaxed);
+        stats.tasksDropped = tasksDropped_.load(std::memory_order_relaxed);
+        stats.tasksCallerRun = tasksCallerRun_.load(std::memory_order_relaxed);
+        stats.tasksShed = tasksShed_.load(std::memory_order_relaxed);
+
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(workerMtx_);
+        stats.workers.clear();
+        stats.longRunningTasks.clear();
+        for(auto& record : workers_) {
+            collectLongTask(*record, now, stats.longRunningTasks);
+
+            int64_t exitTime = record->exitTime;
+            int64_t lifetime = exitTime != 0 ? exitTime : toNs(now - record->startTime);
+
+            WorkerStats worker;
+            worker.threadName = record->threadName;
+            worker.taskCount = record->taskCount.load(std::memory_order_relaxed);
+            worker.busyRatio = lifetime > 0 ? static_cast<double>(record->busyNs) / lifetime : 0.0;
+            worker.exited = exitTime != 0;
+            stats.workers.emplace_back(worker);
+        }
+    }
+
+private:
+    // 统计分片，按缓存行对齐
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> enqueueCount{0};     // 入队任务数
+        std::atomic<uint64_t> dequeueCount{0};     // 出队任务数
+        LogHistogram queueWait;                    // 队列等待时间
+        LogHistogram execTime;                     // 执行时间
+    };
+
+    // 当前线程对应的分片，线程首次使用时按轮转方式分配
+    Shard& localShard() {
+        static std::atomic_uint nextShard(0);
+        static thread_local unsigned shardIndex = nextShard++ % SHARD_COUNT;
+        return shards_[shardIndex];
+    }
+
+    // 读取一个被标记的任务，读取期间任务状态发生变化则放弃
+    static void collectLongTask(const WorkerRecord& record, Clock::time_point now, std::vector<LongTaskInfo>& tasks) {
+        uint64_t state = record.runState.load(std::memory_order_acquire);
+        if(!(state & 1)) {
+            return;
+        }
+
+        const char* label = record.siteLabel.load(std::memory_order_relaxed);
+        const char* file = record.siteFile.load(std::memory_order_relaxed);
+        int line = record.siteLine.load(std::memory_order_relaxed);
+        int64_t begin = record.taskBegin.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(record.runState.load(std::memory_order_relaxed) != state) {
+            return;
+        }
+
+        LongTaskInfo task;
+        task.threadName = record.threadName;
+        task.label = label != nullptr ? label : "";
+        task.file = file != nullptr ? file : "";
+        task.line = line;
+        task.runningMs = toNs(now - Clock::time_point(Clock::duration(begin))) / 1e6;
+        tasks.emplace_back(std::move(task));
+    }
+
+    template<typename Duration>
+    static int64_t toNs(Duration duration) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
+private:
+    Shard shards_[SHARD_COUNT];                                 // 统计分片
+    std::atomic<uint64_t> threadsSpawned_{0};                   // 动态创建的线程数量
+    std::atomic<uint64_t> threadsReaped_{0};                    // 超时回收的线程数量
+    std::atomic<uint64_t> longTasksFlagged_{0};                 // 被标记的长时间运行任务数量
+    std::atomic<uint64_t> tasksRejected_{0};                    // 提交失败的任务数量
+    std::atomic<uint64_t> tasksDropped_{0};                     // 被丢弃的任务数量
+    std::atomic<uint64_t> tasksCallerRun_{0};                   // 在提交线程上执行的任务数量
+    std::atomic<uint64_t> tasksShed_{0};                        // 准入控制拒绝的任务数量
+    std::mutex workerMtx_;                                      // 保证工作线程记录容器的线程安全
+    std::vector<std::shared_ptr<WorkerRecord>> workers_;        // 各工作线程的统计记录
+};
+
+// 关闭统计时的收集器，接口与PoolStatsCollector一致，所有记录操作为空
+/*
+    - 作为BasicThreadPool的统计策略时，统计相关的计数、直方图与时间戳读取在编译期被移除
+    - 不记录工作线程的任务状态，看门狗无法标记长时间运行的任务
+*/
+class NullStatsCollector
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using WorkerRecord = PoolStatsCollector::WorkerRecord;
+
+    static constexpr bool ENABLED = false;
+
+    void onEnqueue() {}
+    void onDequeue(Clock::time_point, Clock::time_point) {}
+    void onExecuted(WorkerRecord*, Clock::time_point, Clock::time_point, bool) {}
+    void onThreadSpawned() {}
+    void onThreadReaped() {}
+    void onRejected() {}
+    void onDropped() {}
+    void onCallerRuns() {}
+    void onShed() {}
+    void onTaskBegin(WorkerRecord*, Clock::time_point, const char*, const char*, int) {}
+    bool onTaskEnd(WorkerRecord*) { return false; }
+
+    template<typename OnFlagged>
+    size_t flagLongTasks(Clock::time_point, Clock::duration, std::atomic_int&, OnFlagged) {
+        return 0;
+    }
+
+    std::shared_ptr<WorkerRecord> registerWorker(const std::string&) {
+        return nullptr;
+    }
+
+    void onWorkerExit(WorkerRecord*) {}
+
+    // 由收集器维护的部分均为0
+    void fill(PoolStats& stats) {
+        stats.enqueueCount = 0;
+        stats.dequeueCount = 0;
+        stats.threadsSpawned = 0;
+        stats.threadsReaped = 0;
+        stats.longTasksFlagged = 0;
+        stats.tasksRejected = 0;
+        stats.tasksDropped = 0;
+        stats.tasksCallerRun = 0;
+        stats.tasksShed = 0;
+        stats.workers.clear();
+        stats.longRunningTasks.clear();
+    }
+};
+
+#endif
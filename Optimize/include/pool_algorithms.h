@@ -0,0 +1,291 @@
+#ifndef __POOL_ALGORITHMS_H__
+#define __POOL_ALGORITHMS_H__
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include "threadpoolOpt.h"
+#include "taskGroup.h"
+
+// 基于线程池的并行算法
+/*
+    - 所有算法均要求随机访问迭代器，语义与对应的STL串行算法一致
+    - 数据被切分为若干连续分块，通过TaskGroup分发到线程池，
+      调用线程在等待期间同样会执行分块任务，1个工作线程时也能保证进度
+    - 规模小于SERIAL_CUTOFF时直接退化为串行算法，避免任务调度开销
+    - pool可为任意策略组合的BasicThreadPool
+*/
+namespace parallel {
+
+// 低于该规模时串行执行
+const size_t SERIAL_CUTOFF = 1 << 14;
+
+namespace detail {
+
+// 计算分块数量，每个线程分配若干分块以平衡负载
+template<typename Pool>
+size_t chunkCount(Pool& pool, size_t n) {
+    size_t threads = std::max<size_t>(pool.getThreadSize(), 1) + 1;   // 调用线程也参与计算
+    size_t chunks = threads * 4;
+    return std::max<size_t>(std::min(chunks, n / (SERIAL_CUTOFF / 4) + 1), 1);
+}
+
+// 将[0, n)切分为chunks个连续分块并行执行func(chunkIndex, begin, end)
+template<typename Pool, typename Func>
+void forEachChunk(Pool& pool, size_t n, size_t chunks, Func&& func) {
+    BasicTaskGroup<Pool> group(pool);
+    for(size_t i = 1; i < chunks; ++i) {
+        group.run([&func, i, n, chunks]() {
+            func(i, n * i / chunks, n * (i + 1) / chunks);
+        });
+    }
+
+    // 调用线程执行第一个分块
+    func(0, 0, n / chunks);
+    group.wait();
+}
+
+// 并行归并[first1, last1)与[first2, last2)到dest
+template<typename Pool, typename RandomIt1, typename RandomIt2, typename Compare>
+void parallelMerge(Pool& pool, RandomIt1 first1, RandomIt1 last1,
+                   RandomIt1 first2, RandomIt1 last2, RandomIt2 dest, Compare comp) {
+    size_t n1 = last1 - first1;
+    size_t n2 = last2 - first2;
+    if(n1 + n2 <= SERIAL_CUTOFF) {
+        std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+                   std::make_move_iterator(first2), std::make_move_iterator(last2), dest, comp);
+        return;
+    }
+
+    // 以较长序列的中点为界，在另一序列中二分查找分割点，保证归并稳定
+    RandomIt1 mid1, mid2;
+    if(n1 >= n2) {
+        mid1 = first1 + n1 / 2;
+        mid2 = std::lower_bound(first2, last2, *mid1, comp);
+    }
+    else {
+        mid2 = first2 + n2 / 2;
+        mid1 = std::upper_bound(first1, last1, *mid2, comp);
+    }
+    RandomIt2 destMid = dest + (mid1 - first1) + (mid2 - first2);
+
+    BasicTaskGroup<Pool> group(pool);
+    group.run([&]() {
+        parallelMerge(pool, first1, mid1, first2, mid2, dest, comp);
+    });
+    parallelMerge(pool, mid1, last1, mid2, last2, destMid, comp);
+    group.wait();
+}
+
+// 并行归并排序，结果写回[first, last)，buffer为等长的临时空间
+// inBuffer为true时表示结果需要写入buffer
+template<typename Pool, typename RandomIt, typename BufIt, typename Compare>
+void mergeSort(Pool& pool, RandomIt first, RandomIt last, BufIt buffer, Compare comp, bool inBuffer) {
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        std::stable_sort(first, last, comp);
+        if(inBuffer) {
+            std::move(first, last, buffer);
+        }
+        return;
+    }
+
+    RandomIt mid = first + n / 2;
+    BufIt bufMid = buffer + n / 2;
+
+    // 两个子区间的结果写到与本层相反的位置，再归并回本层的目标位置
+    BasicTaskGroup<Pool> group(pool);
+    group.run([&]() {
+        mergeSort(pool, first, mid, buffer, comp, !inBuffer);
+    });
+    mergeSort(pool, mid, last, bufMid, comp, !inBuffer);
+    group.wait();
+
+    if(inBuffer) {
+        parallelMerge(pool, first, mid, mid, last, buffer, comp);
+    }
+    else {
+        parallelMerge(pool, buffer, bufMid, bufMid, buffer + n, first, comp);
+    }
+}
+
+} // namespace detail
+
+// 并行for_each
+template<typename Pool, typename RandomIt, typename UnaryFunc>
+void for_each(Pool& pool, RandomIt first, RandomIt last, UnaryFunc func) {
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        std::for_each(first, last, func);
+        return;
+    }
+
+    detail::forEachChunk(pool, n, detail::chunkCount(pool, n), [&](size_t, size_t begin, size_t end) {
+        std::for_each(first + begin, first + end, func);
+    });
+}
+
+// 并行transform
+template<typename Pool, typename RandomIt1, typename RandomIt2, typename UnaryOp>
+RandomIt2 transform(Pool& pool, RandomIt1 first, RandomIt1 last, RandomIt2 dest, UnaryOp op) {
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        return std::transform(first, last, dest, op);
+    }
+
+    detail::forEachChunk(pool, n, detail::chunkCount(pool, n), [&](size_t, size_t begin, size_t end) {
+        std::transform(first + begin, first + end, dest + begin, op);
+    });
+    return dest + n;
+}
+
+// 并行count_if
+template<typename Pool, typename RandomIt, typename UnaryPred>
+size_t count_if(Pool& pool, RandomIt first, RandomIt last, UnaryPred pred) {
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        return std::count_if(first, last, pred);
+    }
+
+    size_t chunks = detail::chunkCount(pool, n);
+    std::vector<size_t> counts(chunks, 0);
+    detail::forEachChunk(pool, n, chunks, [&](size_t i, size_t begin, size_t end) {
+        counts[i] = std::count_if(first + begin, first + end, pred);
+    });
+    return std::accumulate(counts.begin(), counts.end(), size_t(0));
+}
+
+// 并行min_element，多个最小值时返回第一个
+template<typename Pool, typename RandomIt, typename Compare = std::less<>>
+RandomIt min_element(Pool& pool, RandomIt first, RandomIt last, Compare comp = Compare()) {
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        return std::min_element(first, last, comp);
+    }
+
+    size_t chunks = detail::chunkCount(pool, n);
+    std::vector<RandomIt> results(chunks);
+    detail::forEachChunk(pool, n, chunks, [&](size_t i, size_t begin, size_t end) {
+        results[i] = std::min_element(first + begin, first + end, comp);
+    });
+
+    // 按分块顺序比较，保证返回第一个最小值
+    return *std::min_element(results.begin(), results.end(), [&](RandomIt a, RandomIt b) {
+        return comp(*a, *b);
+    });
+}
+
+// 并行max_element，多个最大值时返回第一个
+template<typename Pool, typename RandomIt, typename Compare = std::less<>>
+RandomIt max_element(Pool& pool, RandomIt first, RandomIt last, Compare comp = Compare()) {
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        return std::max_element(first, last, comp);
+    }
+
+    size_t chunks = detail::chunkCount(pool, n);
+    std::vector<RandomIt> results(chunks);
+    detail::forEachChunk(pool, n, chunks, [&](size_t i, size_t begin, size_t end) {
+        results[i] = std::max_element(first + begin, first + end, comp);
+    });
+
+    return *std::max_element(results.begin(), results.end(), [&](RandomIt a, RandomIt b) {
+        return comp(*a, *b);
+    });
+}
+
+// 并行inclusive_scan
+/*
+    两遍扫描：
+        1. 各分块并行求局部和
+        2. 串行计算各分块的前缀偏移，再各分块并行以偏移为初值做局部扫描
+    要求op满足结合律
+*/
+template<typename Pool, typename RandomIt1, typename RandomIt2, typename BinaryOp = std::plus<>>
+RandomIt2 inclusive_scan(Pool& pool, RandomIt1 first, RandomIt1 last, RandomIt2 dest, BinaryOp op = BinaryOp()) {
+    using valueType = typename std::iterator_traits<RandomIt1>::value_type;
+
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        return std::inclusive_scan(first, last, dest, op);
+    }
+
+    size_t chunks = detail::chunkCount(pool, n);
+    std::vector<valueType> sums(chunks);
+    detail::forEachChunk(pool, n, chunks, [&](size_t i, size_t begin, size_t end) {
+        valueType sum = first[begin];
+        for(size_t k = begin + 1; k < end; ++k) {
+            sum = op(sum, first[k]);
+        }
+        sums[i] = sum;
+    });
+
+    // 各分块的前缀偏移
+    for(size_t i = 1; i < chunks; ++i) {
+        sums[i] = op(sums[i - 1], sums[i]);
+    }
+
+    detail::forEachChunk(pool, n, chunks, [&](size_t i, size_t begin, size_t end) {
+        if(i == 0) {
+            std::inclusive_scan(first + begin, first + end, dest + begin, op);
+        }
+        else {
+            std::inclusive_scan(first + begin, first + end, dest + begin, op, sums[i - 1]);
+        }
+    });
+    return dest + n;
+}
+
+// 并行exclusive_scan，要求op满足结合律
+template<typename Pool, typename RandomIt1, typename RandomIt2, typename T, typename BinaryOp = std::plus<>>
+RandomIt2 exclusive_scan(Pool& pool, RandomIt1 first, RandomIt1 last, RandomIt2 dest, T init, BinaryOp op = BinaryOp()) {
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        return std::exclusive_scan(first, last, dest, init, op);
+    }
+
+    size_t chunks = detail::chunkCount(pool, n);
+    std::vector<T> sums(chunks);
+    detail::forEachChunk(pool, n, chunks, [&](size_t i, size_t begin, size_t end) {
+        T sum = first[begin];
+        for(size_t k = begin + 1; k < end; ++k) {
+            sum = op(sum, first[k]);
+        }
+        sums[i] = sum;
+    });
+
+    // 各分块的初值：init与之前所有分块的和
+    T carry = init;
+    for(size_t i = 0; i < chunks; ++i) {
+        T sum = sums[i];
+        sums[i] = carry;
+        carry = op(carry, sum);
+    }
+
+    detail::forEachChunk(pool, n, chunks, [&](size_t i, size_t begin, size_t end) {
+        std::exclusive_scan(first + begin, first + end, dest + begin, sums[i], op);
+    });
+    return dest + n;
+}
+
+// 并行稳定归并排序，需要与输入等长的临时空间
+template<typename Pool, typename RandomIt, typename Compare = std::less<>>
+void sort(Pool& pool, RandomIt first, RandomIt last, Compare comp = Compare()) {
+    using valueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    size_t n = last - first;
+    if(n <= SERIAL_CUTOFF) {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+
+    std::vector<valueType> buffer(n);
+    detail::mergeSort(pool, first, last, buffer.begin(), comp, false);
+}
+
+} // namespace parallel
+
+#endif
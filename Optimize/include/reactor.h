@@ -0,0 +1,177 @@
+#ifndef __REACTOR_H__
+#define __REACTOR_H__
+
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <exception>
+#include <unordered_map>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "threadpoolOpt.h"
+#include "idlePoller.h"
+#include "logger.h"
+
+// 与线程池共享工作线程的epoll反应器
+/*
+    - 构造时注册为线程池的空闲轮询器，任务队列为空时由一个空闲工作线程阻塞在epoll_wait上，
+      就绪事件的回调直接在该工作线程上执行，省去独立I/O线程 + submitTask的两次线程切换
+    - 有新任务而没有其它空闲线程时，线程池通过eventfd唤醒轮询线程回去执行任务
+    - 回调在工作线程上执行，不应长时间阻塞；耗时的处理请在回调中再submitTask
+    - 反应器需在线程池之前析构
+    - Pool为线程池类型，可为任意策略组合的BasicThreadPool，Reactor为默认线程池的别名
+
+    使用示例：
+        Reactor reactor(pool);
+        reactor.add(fd, EPOLLIN, [](uint32_t events) { ... });
+*/
+template<typename Pool = ThreadPool>
+class BasicReactor : public IdlePoller
+{
+public:
+    // 就绪事件回调，参数为就绪的epoll事件
+    using Callback = std::function<void(uint32_t)>;
+
+    static const int MAX_EVENTS = 64;       // 单次epoll_wait返回的最大事件数
+
+    // 构造函数
+    explicit BasicReactor(Pool& pool)
+        : pool_(pool)
+        , epollFd_(epoll_create1(EPOLL_CLOEXEC))
+        , wakeupFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        if(epollFd_ < 0 || wakeupFd_ < 0) {
+            LOG_ERROR() << "Reactor init failed: " << strerror(errno);
+            return;
+        }
+
+        // 唤醒用的eventfd，data.fd区分普通fd与唤醒事件
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = wakeupFd_;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupFd_, &event);
+
+        pool_.addIdlePoller(this);
+    }
+
+    // 析构函数
+    ~BasicReactor() {
+        if(isValid()) {
+            pool_.removeIdlePoller(this);
+        }
+        if(epollFd_ >= 0) {
+            close(epollFd_);
+        }
+        if(wakeupFd_ >= 0) {
+            close(wakeupFd_);
+        }
+    }
+
+    // 禁止对反应器进行拷贝构造/赋值
+    BasicReactor(const BasicReactor&) = delete;
+    BasicReactor& operator=(const BasicReactor&) = delete;
+
+    // 反应器是否初始化成功
+    bool isValid() const {
+        return epollFd_ >= 0 && wakeupFd_ >= 0;
+    }
+
+    // 注册fd，events为EPOLLIN/EPOLLOUT/EPOLLET/EPOLLONESHOT等的组合
+    bool add(int fd, uint32_t events, Callback callback) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            handlers_[fd] = std::make_shared<Callback>(std::move(callback));
+        }
+        return control(EPOLL_CTL_ADD, fd, events);
+    }
+
+    // 修改fd关注的事件，EPOLLONESHOT的fd在回调中通过该接口重新启用
+    bool modify(int fd, uint32_t events) {
+        return control(EPOLL_CTL_MOD, fd, events);
+    }
+
+    // 注销fd，需在关闭fd之前调用
+    bool remove(int fd) {
+        bool ok = control(EPOLL_CTL_DEL, fd, 0);
+        std::lock_guard<std::mutex> lock(mtx_);
+        handlers_.erase(fd);
+        return ok;
+    }
+
+    // 等待就绪事件并在当前线程执行回调，由线程池的空闲工作线程调用
+    bool poll(int timeoutMs) override {
+        epoll_event events[MAX_EVENTS];
+        int n = epoll_wait(epollFd_, events, MAX_EVENTS, timeoutMs);
+
+        bool handled = false;
+        for(int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if(fd == wakeupFd_) {
+                uint64_t value;
+                while(read(wakeupFd_, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+
+            // 复制回调的共享指针，回调执行期间fd被注销也不会访问悬垂对象
+            std::shared_ptr<Callback> handler;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                auto it = handlers_.find(fd);
+                if(it == handlers_.end()) {
+                    continue;
+                }
+                handler = it->second;
+            }
+
+            // 回调不在任务的异常捕获范围内，异常在此捕获并记录，避免终止工作线程
+            try {
+                (*handler)(events[i].events);
+            }
+            catch(const std::exception& e) {
+                LOG_ERROR() << "Reactor callback for fd " << fd << " threw: " << e.what();
+            }
+            catch(...) {
+                LOG_ERROR() << "Reactor callback for fd " << fd << " threw an unknown exception";
+            }
+            handled = true;
+        }
+        return handled;
+    }
+
+    // 唤醒阻塞在epoll_wait上的线程
+    void wakeup() override {
+        uint64_t value = 1;
+        ssize_t ret = write(wakeupFd_, &value, sizeof(value));
+        (void)ret;
+    }
+
+private:
+    // 调用epoll_ctl
+    bool control(int op, int fd, uint32_t events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        if(epoll_ctl(epollFd_, op, fd, &event) < 0) {
+            LOG_ERROR() << "epoll_ctl failed on fd " << fd << ": " << strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    Pool& pool_;                                                        // 共享工作线程的线程池
+    int epollFd_;                                                       // epoll实例
+    int wakeupFd_;                                                      // 唤醒轮询线程的eventfd
+    std::mutex mtx_;                                                    // 保证回调容器的线程安全
+    std::unordered_map<int, std::shared_ptr<Callback>> handlers_;       // 各fd的回调
+};
+
+// 默认策略线程池的反应器
+using Reactor = BasicReactor<>;
+
+#endif
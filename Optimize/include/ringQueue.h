@@ -0,0 +1,77 @@
+#ifndef __RINGQUEUE_H__
+#define __RINGQUEUE_H__
+
+#include <vector>
+#include <optional>
+#include <utility>
+#include <cstddef>
+
+// 基于环形缓冲区的FIFO队列，接口与std::queue一致
+/*
+    - 元素连续存放，容量为2的幂，下标通过按位与取模
+    - 容量不足时加倍扩容，稳定运行后入队出队不再分配内存；std::queue（std::deque）每512字节分配一个块
+    - 非线程安全，由调用方加锁
+*/
+template<typename T>
+class RingQueue
+{
+public:
+    static const size_t INIT_CAPACITY = 64;     // 初始容量
+
+    RingQueue()
+        : buffer_(INIT_CAPACITY)
+        , head_(0)
+        , size_(0)
+    {}
+
+    // 入队
+    void emplace(T&& value) {
+        if(size_ == buffer_.size()) {
+            grow();
+        }
+        buffer_[(head_ + size_) & (buffer_.size() - 1)].emplace(std::move(value));
+        size_++;
+    }
+
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    // 队头元素
+    T& front() {
+        return *buffer_[head_];
+    }
+
+    // 出队，立即析构队头元素，释放其持有的资源
+    void pop() {
+        buffer_[head_].reset();
+        head_ = (head_ + 1) & (buffer_.size() - 1);
+        size_--;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+private:
+    // 容量加倍，元素按FIFO顺序移动到新缓冲区的起始位置
+    void grow() {
+        std::vector<std::optional<T>> buffer(buffer_.size() * 2);
+        for(size_t i = 0; i < size_; ++i) {
+            buffer[i] = std::move(buffer_[(head_ + i) & (buffer_.size() - 1)]);
+        }
+        buffer_.swap(buffer);
+        head_ = 0;
+    }
+
+private:
+    std::vector<std::optional<T>> buffer_;      // 环形缓冲区
+    size_t head_;                               // 队头下标
+    size_t size_;                               // 元素数量
+};
+
+#endif
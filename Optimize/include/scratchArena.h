@@ -0,0 +1,156 @@
+#ifndef __SCRATCHARENA_H__
+#define __SCRATCHARENA_H__
+
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 任务临时内存区，按指针递增分配的std::pmr::memory_resource
+/*
+    - 分配只移动当前块内的偏移，deallocate()不做任何事，内存在reset()/rewind()时整体回收
+    - reset()保留已申请的内存：用过多个块时合并为一个总大小相同的块，稳定运行后每个任务不再向上游申请内存；
+      std::pmr::monotonic_buffer_resource::release()会把内存全部归还上游，下一个任务仍需重新申请
+    - 保留的内存超过MAX_RETAINED_SIZE时归还上游，避免个别大任务长期占用内存
+    - 非线程安全，每个工作线程一个，由线程池在任务结束后重置
+
+    使用示例：
+        pool.submitTask([&pool]() {
+            std::pmr::vector<char> buffer(&pool.scratchArena());
+            buffer.resize(1 << 20);
+            ...
+        });
+*/
+class ScratchArena : public std::pmr::memory_resource
+{
+public:
+    static const size_t INIT_CHUNK_SIZE = 64 * 1024;                // 首个块的大小
+    static const size_t MAX_RETAINED_SIZE = 16 * 1024 * 1024;       // reset()后保留内存的上限
+
+    // 分配位置，用于嵌套任务结束后回退
+    struct Mark
+    {
+        size_t chunk;       // 当前块的下标
+        size_t offset;      // 当前块内的偏移
+    };
+
+    explicit ScratchArena(size_t initChunkSize = INIT_CHUNK_SIZE,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : initChunkSize_(initChunkSize)
+        , upstream_(upstream)
+        , current_(0)
+        , offset_(0)
+    {}
+
+    ~ScratchArena() {
+        releaseChunks();
+    }
+
+    // 禁止对临时内存区进行拷贝构造/赋值
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // 当前分配位置
+    Mark mark() const {
+        return Mark{ current_, offset_ };
+    }
+
+    // 回退到mark()记录的位置，之后分配的内存全部回收，已申请的块保留
+    void rewind(const Mark& mark) {
+        current_ = mark.chunk;
+        offset_ = mark.offset;
+    }
+
+    // 回收全部已分配的内存，合并或归还已申请的块
+    void reset() {
+        current_ = 0;
+        offset_ = 0;
+        if(chunks_.size() <= 1 && capacity() <= MAX_RETAINED_SIZE) {
+            return;
+        }
+
+        size_t total = capacity();
+        releaseChunks();
+        if(total <= MAX_RETAINED_SIZE) {
+            addChunk(total);
+        }
+    }
+
+    // 已申请的内存总量
+    size_t capacity() const {
+        size_t total = 0;
+        for(auto& chunk : chunks_) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        // 依次尝试当前块与之后保留的块
+        for(; current_ < chunks_.size(); ++current_, offset_ = 0) {
+            if(void* ptr = bump(bytes, alignment)) {
+                return ptr;
+            }
+        }
+
+        // 申请新块，大小为上一个块的两倍，且足够容纳本次分配
+        size_t size = chunks_.empty() ? initChunkSize_ : chunks_.back().size * 2;
+        if(size < bytes + alignment) {
+            size = bytes + alignment;
+        }
+        addChunk(size);
+        current_ = chunks_.size() - 1;
+        offset_ = 0;
+        return bump(bytes, alignment);
+    }
+
+    // 单个分配不回收，由reset()/rewind()整体回收
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    // 已申请的块
+    struct Chunk
+    {
+        char* data;         // 起始地址
+        size_t size;        // 大小
+    };
+
+    // 在当前块内分配，空间不足时返回nullptr
+    void* bump(size_t bytes, size_t alignment) {
+        Chunk& chunk = chunks_[current_];
+        uintptr_t begin = reinterpret_cast<uintptr_t>(chunk.data) + offset_;
+        uintptr_t aligned = (begin + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        size_t end = aligned - reinterpret_cast<uintptr_t>(chunk.data) + bytes;
+        if(end > chunk.size) {
+            return nullptr;
+        }
+        offset_ = end;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void addChunk(size_t size) {
+        char* data = static_cast<char*>(upstream_->allocate(size, alignof(std::max_align_t)));
+        chunks_.emplace_back(Chunk{ data, size });
+    }
+
+    void releaseChunks() {
+        for(auto& chunk : chunks_) {
+            upstream_->deallocate(chunk.data, chunk.size, alignof(std::max_align_t));
+        }
+        chunks_.clear();
+    }
+
+private:
+    size_t initChunkSize_;                      // 首个块的大小
+    std::pmr::memory_resource* upstream_;       // 申请块的上游内存资源
+    std::vector<Chunk> chunks_;                 // 已申请的块
+    size_t current_;                            // 当前分配的块下标
+    size_t offset_;                             // 当前块内已分配的偏移
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef __TASKFUTURE_H__
+#define __TASKFUTURE_H__
+
+#include <atomic>
+#include <memory>
+#include <future>
+#include <functional>
+#include <stdexcept>
+
+// 任务完成通知，由执行任务的线程在任务结束（包括被拒绝）后触发
+/*
+    - 每个任务最多注册一个完成回调，注册与触发之间通过一个原子状态同步，不加锁
+    - 注册时任务已完成，则在注册线程上立即执行回调；否则由执行任务的工作线程执行回调
+    - 回调在工作线程上执行，不应长时间阻塞
+*/
+class TaskCompletion
+{
+public:
+    // 注册完成回调，同一任务重复注册时抛出std::logic_error
+    void then(std::function<void()> callback) {
+        int state = state_.load(std::memory_order_acquire);
+        if(state == STATE_CALLBACK) {
+            throw std::logic_error("TaskCompletion: callback already registered");
+        }
+
+        if(state == STATE_PENDING) {
+            callback_ = std::move(callback);
+            if(state_.compare_exchange_strong(state, STATE_CALLBACK, std::memory_order_acq_rel)) {
+                return;
+            }
+            // 注册期间任务已完成
+            callback = std::move(callback_);
+        }
+        callback();
+    }
+
+    // 任务结束，执行已注册的回调
+    void fire() {
+        if(state_.exchange(STATE_DONE, std::memory_order_acq_rel) == STATE_CALLBACK) {
+            std::function<void()> callback = std::move(callback_);
+            callback();
+        }
+    }
+
+    // 任务是否已结束
+    bool isDone() const {
+        return state_.load(std::memory_order_acquire) == STATE_DONE;
+    }
+
+private:
+    static const int STATE_PENDING = 0;     // 未结束，未注册回调
+    static const int STATE_CALLBACK = 1;    // 未结束，已注册回调
+    static const int STATE_DONE = 2;        // 已结束
+
+    std::atomic<int> state_{STATE_PENDING};     // 完成状态
+    std::function<void()> callback_;            // 完成回调
+};
+
+// 线程池任务的future，在std::future的基础上可注册完成回调
+// 可直接转换为std::future，原有以std::future接收submitTask返回值的代码不受影响
+template<typename R>
+class TaskFuture : public std::future<R>
+{
+public:
+    TaskFuture() = default;
+
+    TaskFuture(std::future<R>&& future, std::shared_ptr<TaskCompletion> completion)
+        : std::future<R>(std::move(future))
+        , completion_(std::move(completion))
+    {}
+
+    TaskFuture(TaskFuture&&) = default;
+    TaskFuture& operator=(TaskFuture&&) = default;
+
+    // 注册任务完成时执行的回调，每个任务只能注册一次，when_all/when_any同样占用该回调
+    void onComplete(std::function<void()> callback) {
+        if(!completion_) {
+            // 没有完成通知的future视为已完成
+            callback();
+            return;
+        }
+        completion_->then(std::move(callback));
+    }
+
+    // 任务是否已结束，结束后get()不会阻塞
+    bool isReady() const {
+        return !completion_ || completion_->isDone();
+    }
+
+    // 完成通知
+    const std::shared_ptr<TaskCompletion>& completion() const {
+        return completion_;
+    }
+
+private:
+    std::shared_ptr<TaskCompletion> completion_;    // 完成通知
+};
+
+#endif
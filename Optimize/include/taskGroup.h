@@ -0,0 +1,148 @@
+#ifndef __TASKGROUP_H__
+#define __TASKGROUP_H__
+
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+#include "threadpoolOpt.h"
+
+// 任务组，用于结构化的fork-join并行
+/*
+    - 工作线程中直接调用std::future::get()等待子任务会阻塞该工作线程，
+      递归分治的深度超过线程数量时，fixed模式的线程池会发生死锁
+    - TaskGroup::wait()在工作线程中调用时，会先执行本组尚未开始的任务，
+      再协助执行线程池任务队列中的任务，直到本组任务全部完成
+    - 析构函数会等待本组任务全部完成，因此组内任务可以安全地引用调用方栈上的数据
+    - Pool为线程池类型，可为任意策略组合的BasicThreadPool，TaskGroup为默认线程池的别名
+*/
+template<typename Pool = ThreadPool>
+class BasicTaskGroup
+{
+public:
+    // 构造函数
+    explicit BasicTaskGroup(Pool& pool)
+        : pool_(pool)
+        , state_(std::make_shared<State>())
+    {}
+
+    // 析构函数，等待组内任务全部完成
+    ~BasicTaskGroup() {
+        waitDone();
+    }
+
+    // 禁止对任务组进行拷贝构造/赋值
+    BasicTaskGroup(const BasicTaskGroup&) = delete;
+    BasicTaskGroup& operator=(const BasicTaskGroup&) = delete;
+
+    // 向任务组中提交任务
+    template<typename taskFunc>
+    void run(taskFunc&& func) {
+        {
+            std::lock_guard<std::mutex> lock(state_->mtx_);
+            state_->localQue_.emplace_back(std::forward<taskFunc>(func));
+            state_->pendingCount_++;
+        }
+
+        // 向线程池提交一个执行本组任务的代理任务
+        // 代理任务持有State的共享指针，任务组先于代理任务销毁时也不会访问悬垂指针
+        std::shared_ptr<State> state = state_;
+        pool_.submitTask([state]() {
+            state->runOne();
+        });
+    }
+
+    // 等待组内任务全部完成，若组内任务抛出异常，则重新抛出第一个异常
+    void wait() {
+        waitDone();
+
+        std::exception_ptr exception;
+        {
+            std::lock_guard<std::mutex> lock(state_->mtx_);
+            std::swap(exception, state_->exception_);
+        }
+
+        if(exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+private:
+    // 任务组共享状态
+    struct State
+    {
+        // 取出并执行一个本组任务，本组无待执行任务时返回false
+        bool runOne() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if(localQue_.empty()) {
+                    return false;
+                }
+
+                task = std::move(localQue_.front());
+                localQue_.pop_front();
+            }
+
+            try {
+                task();
+            }
+            catch(...) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if(!exception_) {
+                    exception_ = std::current_exception();
+                }
+            }
+
+            // 最后一个任务完成时，通知等待者
+            if(--pendingCount_ == 0) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                doneCond_.notify_all();
+            }
+
+            return true;
+        }
+
+        std::deque<std::function<void()>> localQue_;    // 本组尚未开始的任务
+        std::atomic_size_t pendingCount_{0};            // 本组未完成的任务数量
+        std::exception_ptr exception_;                  // 组内任务抛出的第一个异常
+        std::mutex mtx_;                                // 保证本组任务队列的线程安全
+        std::condition_variable doneCond_;              // 本组任务全部完成
+    };
+
+    // 等待组内任务全部完成
+    void waitDone() {
+        bool inPoolThread = pool_.isInPoolThread();
+
+        while(state_->pendingCount_ > 0) {
+            // 优先执行本组尚未开始的任务，非工作线程中执行时同样可以使用local()/scratchArena()
+            if(pool_.runInline([this]() { return state_->runOne(); })) {
+                continue;
+            }
+
+            // 工作线程协助执行线程池中的其它任务，避免阻塞工作线程
+            if(inPoolThread && pool_.runPendingTask()) {
+                continue;
+            }
+
+            // 本组剩余任务均在其它线程上执行，阻塞等待其完成
+            std::unique_lock<std::mutex> lock(state_->mtx_);
+            state_->doneCond_.wait(lock, [&]()->bool{
+                return state_->pendingCount_ == 0 || !state_->localQue_.empty();
+            });
+        }
+    }
+
+private:
+    Pool& pool_;                        // 任务组所使用的线程池
+    std::shared_ptr<State> state_;      // 任务组共享状态
+};
+
+// 默认策略线程池的任务组
+using TaskGroup = BasicTaskGroup<>;
+
+#endif
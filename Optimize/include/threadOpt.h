@@ -4,6 +4,22 @@
 #include <iostream>
 #include <functional>
 #include <thread>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <system_error>
+#include <cstdint>
+#include <climits>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// 线程属性，0表示使用系统默认值
+struct ThreadAttr
+{
+    size_t stackSize = 0;       // 栈大小，默认8MB（ulimit -s）
+    size_t guardSize = 0;       // 栈保护区大小，默认一页
+};
 
 // 线程类型
 class Thread
@@ -23,12 +39,49 @@ public:
     ~Thread() = default;
 
     // 启动线程
-    void start() {
-        // 创建线程用来执行线程函数
-        std::thread t(func_, threadId_);
+    // 以pthread创建分离线程，以便设置栈大小与保护区大小，并将线程名称设置为系统线程名
+    void start(const ThreadAttr& threadAttr = ThreadAttr()) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if(threadAttr.stackSize > 0) {
+            pthread_attr_setstacksize(&attr, std::max<size_t>(threadAttr.stackSize, PTHREAD_STACK_MIN));
+        }
+        if(threadAttr.guardSize > 0) {
+            pthread_attr_setguardsize(&attr, threadAttr.guardSize);
+        }
+
+        // 线程对象可能先于线程函数返回被销毁，因此将启动参数复制一份交给新线程
+        auto* context = new StartContext{ func_, threadId_, name_ };
+        pthread_t tid;
+        int ret = pthread_create(&tid, &attr, &Thread::entry, context);
+        pthread_attr_destroy(&attr);
+
+        if(ret != 0) {
+            delete context;
+            throw std::system_error(ret, std::generic_category(), "pthread_create");
+        }
+    }
+
+    // 释放当前线程栈中未使用部分占用的物理内存，用于线程长时间空闲前
+    // 栈向低地址增长，当前栈顶以下（预留STACK_RELEASE_MARGIN）的页面通过MADV_DONTNEED交还给系统
+    static void releaseUnusedStack() {
+        pthread_attr_t attr;
+        if(pthread_getattr_np(pthread_self(), &attr) != 0) {
+            return;
+        }
+        void* stackAddr = nullptr;
+        size_t stackSize = 0;
+        pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+        pthread_attr_destroy(&attr);
 
-        // 设置分离线程
-        t.detach();
+        uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        char marker = 0;
+        uintptr_t low = (reinterpret_cast<uintptr_t>(stackAddr) + page - 1) & ~(page - 1);
+        uintptr_t high = (reinterpret_cast<uintptr_t>(&marker) - STACK_RELEASE_MARGIN) & ~(page - 1);
+        if(high > low) {
+            madvise(reinterpret_cast<void*>(low), high - low, MADV_DONTNEED);
+        }
     }
 
     // 获取线程id
@@ -41,6 +94,28 @@ public:
         return name_;
     }
 
+private:
+    static const uintptr_t STACK_RELEASE_MARGIN = 16 * 1024;   // 释放栈内存时在当前栈顶以下保留的大小
+
+    // 新线程的启动参数
+    struct StartContext
+    {
+        ThreadFunc func;
+        size_t threadId;
+        std::string name;
+    };
+
+    // 新线程入口
+    static void* entry(void* arg) {
+        std::unique_ptr<StartContext> context(static_cast<StartContext*>(arg));
+
+        // 系统线程名最长15个字符
+        pthread_setname_np(pthread_self(), context->name.substr(0, 15).c_str());
+
+        context->func(context->threadId);
+        return nullptr;
+    }
+
 private:
     ThreadFunc func_;           // 线程执行函数
     std::string name_;          // 线程名称
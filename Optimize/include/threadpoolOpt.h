@@ -9,14 +9,37 @@
 #include <condition_variable>
 #include <chrono>
 #include <unordered_map>
+#include <unordered_set>
+#include <set>
+#include <stdexcept>
+#include <exception>
 #include <future>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <typeindex>
+#include <optional>
 
 #include "threadOpt.h"
+#include "perfCounter.h"
+#include "poolStats.h"
 #include "logger.h"
+#include "tracer.h"
+#include "lockProfiler.h"
+#include "idlePoller.h"
+#include "asyncFile.h"
+#include "cpuLimit.h"
+#include "ringQueue.h"
+#include "taskFuture.h"
+#include "scratchArena.h"
 
 const int TASK_MAX_THRESHOLD   = INT32_MAX;     // 最大任务量
 const int THREAD_MAX_THRESHOLD = 1024;          // 线程池中最大线程数
 const int THREAD_MAX_IDLE_TIME = 60;            // 提交任务超时时间，单位：s
+const int IDLE_POLL_TIMEOUT    = 1000;          // 空闲线程单次阻塞在轮询器上的最长时间，单位：ms
+const int STACK_RELEASE_IDLE_TIME = 1;          // 开启空闲栈释放时，线程空闲超过该时间后释放栈内存，单位：s
+const int CPU_LIMIT_WATCH_INTERVAL = 1000;      // 跟随CPU配额调整线程数量时的检查周期，单位：ms
+const size_t MAX_PERF_RECORDS = 1024;           // 性能计数记录数量上限，超过时合并已回收线程的记录
 
 // 线程池模式
 enum class PoolMode {
@@ -24,63 +47,380 @@ enum class PoolMode {
     MODE_CACHED         // cached模式
 };
 
-// 线程池类型
-class ThreadPool
+// 任务队列已满时的溢出策略
+enum class OverflowPolicy {
+    POLICY_BLOCK,           // 阻塞提交线程，直到任务队列未满
+    POLICY_TIMEOUT,         // 阻塞提交线程，超过等待时间后提交失败
+    POLICY_FAIL_FAST,       // 立即提交失败
+    POLICY_CALLER_RUNS,     // 在提交线程上直接执行任务
+    POLICY_DROP_OLDEST      // 丢弃任务队列中最早的任务，被丢弃的任务提交失败
+};
+
+// 任务优先级，开启准入控制后，排队时延超过目标值时拒绝新提交的低优先级任务
+enum class TaskPriority {
+    PRIORITY_LOW,           // 低优先级，过载时可被拒绝
+    PRIORITY_NORMAL         // 普通优先级，不受准入控制影响
+};
+
+// 任务被拒绝（提交失败或被丢弃）时，通过future抛出的异常
+class TaskRejectedError : public std::runtime_error
 {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// 任务的提交位置，供看门狗报告长时间运行的任务
+// label与file需为字符串常量，推荐使用TASK_SITE宏构造
+struct TaskSite
+{
+    const char* label = nullptr;    // 任务标签
+    const char* file = nullptr;     // 提交所在文件
+    int line = 0;                   // 提交所在行
+};
+
+// 以当前源码位置构造TaskSite
+#define TASK_SITE(label) TaskSite{ (label), __FILE__, __LINE__ }
+
+// 提交任务的完整选项
+struct TaskOptions
+{
+    TaskSite site;                                          // 提交位置
+    TaskPriority priority = TaskPriority::PRIORITY_NORMAL;  // 优先级
+    size_t payloadBytes = 0;                                // 任务捕获的数据在堆上占用的字节数，计入任务队列的内存预算
+};
+
+//// 线程池策略，在编译期选择，关闭的功能不生成代码
+// 任务队列容器，均在taskQueMtx_保护下访问
+struct DequeQueuePolicy
+{
+    template<typename T>
+    using Queue = std::queue<T>;                // 基于std::deque的FIFO队列
+};
+
+struct RingQueuePolicy
+{
+    template<typename T>
+    using Queue = RingQueue<T>;                 // 环形缓冲区，稳定运行后不再分配内存
+};
+
+// 空闲线程等待任务的方式
+struct BlockingIdlePolicy
+{
+    static constexpr int SPIN_US = 0;           // 直接阻塞在条件变量上
+};
+
+struct SpinIdlePolicy
+{
+    static constexpr int SPIN_US = 50;          // 阻塞前先自旋等待一段时间（us），降低突发任务的唤醒时延，代价是空转CPU
+};
+
+// 线程数量的增长方式
+struct RuntimeGrowthPolicy
+{
+    static constexpr bool RUNTIME = true;                       // 由setMode()在运行时选择fixed/cached
+    static constexpr PoolMode MODE = PoolMode::MODE_FIXED;      // 默认模式
+};
+
+struct FixedGrowthPolicy
+{
+    static constexpr bool RUNTIME = false;                      // 固定为fixed模式，cached模式的代码不生成
+    static constexpr PoolMode MODE = PoolMode::MODE_FIXED;
+};
+
+struct CachedGrowthPolicy
+{
+    static constexpr bool RUNTIME = false;                      // 固定为cached模式
+    static constexpr PoolMode MODE = PoolMode::MODE_CACHED;
+};
+
+// 运行时统计：PoolStatsCollector开启，NullStatsCollector关闭
+
+// 基于策略的线程池类型
+/*
+    - QueuePolicy：任务队列容器（DequeQueuePolicy / RingQueuePolicy）
+    - IdlePolicy：空闲线程的等待方式（BlockingIdlePolicy / SpinIdlePolicy）
+    - GrowthPolicy：线程池模式（RuntimeGrowthPolicy / FixedGrowthPolicy / CachedGrowthPolicy）
+    - StatsPolicy：运行时统计（PoolStatsCollector / NullStatsCollector）
+    默认参数与原ThreadPool的行为一致，ThreadPool为其别名
+*/
+template<typename QueuePolicy = DequeQueuePolicy,
+         typename IdlePolicy = BlockingIdlePolicy,
+         typename GrowthPolicy = RuntimeGrowthPolicy,
+         typename StatsPolicy = PoolStatsCollector>
+class BasicThreadPool
+{
+private:
+    //// 任务
+    // 参数为空时执行任务，不为空时以该异常拒绝任务
+    using Task = std::function<void(std::exception_ptr)>;
+
+    // 可被拒绝的任务包装，拒绝时任务函数不执行，调用方通过future获取拒绝的异常
+    // std::packaged_task的共享状态保存着构造时传入的函数，future存活期间不会释放，
+    // 因此任务函数由包装单独持有，std::packaged_task只持有this，执行后即销毁任务函数及其捕获的对象
+    template<typename R, typename Func>
+    struct PackagedTask
+    {
+        explicit PackagedTask(Func&& f)
+            : func(std::move(f))
+            , task([this]() -> R {
+                if(rejected) {
+                    std::rethrow_exception(rejected);
+                }
+                return (*func)();
+            })
+        {}
+
+        // 执行（或拒绝）任务，结果写入future后销毁任务函数，再触发完成通知
+        void run() {
+            task();
+            func.reset();
+            completion.fire();
+        }
+
+        std::exception_ptr rejected;            // 拒绝任务的异常
+        std::optional<Func> func;               // 任务函数，执行（或拒绝）后销毁
+        std::packaged_task<R()> task;           // 任务
+        TaskCompletion completion;              // 完成通知
+    };
+
+    // 任务队列中的元素，记录入队时间用于统计排队时延
+    struct TaskItem
+    {
+        Task task;                                                  // 任务
+        std::chrono::steady_clock::time_point enqueueTime;          // 入队时间
+        uint64_t traceId;                                           // 追踪id，0表示未追踪
+        TaskSite site;                                              // 提交位置
+        size_t bytes;                                               // 计入内存预算的字节数
+    };
+
+    // cached模式下空闲线程的回收截止时间与线程id
+    using IdleDeadline = std::pair<std::chrono::steady_clock::time_point, size_t>;
+
+    // 线程在本线程池中的上下文：工作线程局部对象与任务临时内存区
+    struct WorkerContext
+    {
+        std::unordered_map<std::type_index, std::shared_ptr<void>> locals;  // 工作线程局部对象，按类型保存
+        ScratchArena arena;                                                 // 任务临时内存区
+        size_t taskDepth = 0;                                               // 正在嵌套执行的任务层数
+    };
+
+    // 任务执行期间的临时内存区作用域
+    // 最外层任务结束后重置临时内存区，协助执行的嵌套任务结束后回退到其开始时的位置，不影响外层任务已分配的内存
+    class TaskScope
+    {
+    public:
+        explicit TaskScope(WorkerContext& context)
+            : context_(context)
+            , mark_(context.arena.mark())
+        {
+            context_.taskDepth++;
+        }
+
+        ~TaskScope() {
+            if(--context_.taskDepth == 0) {
+                context_.arena.reset();
+            }
+            else {
+                context_.arena.rewind(mark_);
+            }
+        }
+
+        TaskScope(const TaskScope&) = delete;
+        TaskScope& operator=(const TaskScope&) = delete;
+
+    private:
+        WorkerContext& context_;            // 执行任务的线程上下文
+        ScratchArena::Mark mark_;           // 任务开始时的分配位置
+    };
+
+    // 非工作线程执行本线程池任务期间的上下文作用域
+    // 提交线程（POLICY_CALLER_RUNS）或等待线程（协助执行）在最外层任务开始时于栈上创建上下文，任务结束后析构，
+    // 因此上下文不随外部线程的数量增长，也不会被之后复用相同线程id的线程继承；工作线程与嵌套任务不创建
+    class ForeignScope
+    {
+    public:
+        explicit ForeignScope(const BasicThreadPool* pool)
+            : pool_(pool)
+            , previous_(foreignScope_)
+        {
+            if(!pool->isInPoolThread() && pool->findForeignContext() == nullptr) {
+                context_.emplace();
+                foreignScope_ = this;
+            }
+        }
+
+        ~ForeignScope() {
+            if(context_) {
+                foreignScope_ = previous_;
+            }
+        }
+
+        ForeignScope(const ForeignScope&) = delete;
+        ForeignScope& operator=(const ForeignScope&) = delete;
+
+    private:
+        friend class BasicThreadPool;
+
+        const BasicThreadPool* pool_;               // 任务所属的线程池
+        ForeignScope* previous_;                    // 外层其它线程池的作用域
+        std::optional<WorkerContext> context_;      // 执行任务期间的上下文，仅最外层任务创建
+    };
+
 public:
     // 线程池构造函数
-    ThreadPool() 
+    BasicThreadPool() 
         : initThreadSize_(0)
         , taskSize_(0)
         , idleThreadSize_(0)
         , curThreadSize_(0)
         , taskQueMaxThreshold_(TASK_MAX_THRESHOLD)
         , threadSizeThreshold_(THREAD_MAX_THRESHOLD)
-        , poolMode_(PoolMode::MODE_FIXED)
+        , queueBytes_(0)
+        , taskQueMaxBytes_(0)
+        , poolMode_(GrowthPolicy::MODE)
         , isPoolRunning_(false)
+        , perfCounterEnabled_(false)
+        , watchdogThreshold_(0)
+        , watchdogCompensate_(false)
+        , flaggedRunning_(0)
+        , compensateThreadSize_(0)
+        , pollingSize_(0)
+        , overflowPolicy_(OverflowPolicy::POLICY_TIMEOUT)
+        , overflowTimeout_(std::chrono::seconds(1))
+        , admissionTarget_(0)
+        , admissionInterval_(0)
+        , shedding_(false)
+        , retiringSize_(0)
+        , nextThreadIndex_(0)
+        , cpuLimitWatch_(false)
+        , releaseIdleStack_(false)
+        , fileIoMode_(FileIoMode::MODE_AUTO)
+        , workerContexts_(0)
     {}
 
     // 析构函数
-    ~ThreadPool() {
+    ~BasicThreadPool() {
         // 表示需要回收线程池资源
         isPoolRunning_ = false;
 
+        // 停止看门狗线程
+        if(watchdogThread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(watchdogMtx_);
+                watchdogCond_.notify_all();
+            }
+            watchdogThread_.join();
+        }
+
+        // 停止CPU配额跟随线程
+        if(cpuLimitThread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(cpuLimitMtx_);
+                cpuLimitCond_.notify_all();
+            }
+            cpuLimitThread_.join();
+        }
+
+        // 停止回收线程
+        if(reaperThread_.joinable()) {
+            {
+                SiteLock lock(taskQueMtx_);
+                reaperCond_.notify_all();
+            }
+            reaperThread_.join();
+        }
+
         // 等待线程池中所有线程返回
-        std::unique_lock<std::mutex> lock(taskQueMtx_);
+        SiteLock lock(taskQueMtx_);
 
         // 将线程池中阻塞的线程全部唤醒
         taskQueNotEmpty_.notify_all();
+        wakeupIdlePollers();
 
         // 等待线程池中的所有线程执行完毕
         exitCond_.wait(lock, [&]()->bool{
-            return threads_.size() == 0;
+            return threads_.size() == 0 && workerContexts_ == 0;
         });
     }
     
     // 禁止对线程池进行拷贝构造/赋值
-    ThreadPool(const ThreadPool&) = delete;
-    ThreadPool& operator=(const ThreadPool&) = delete;
+    BasicThreadPool(const BasicThreadPool&) = delete;
+    BasicThreadPool& operator=(const BasicThreadPool&) = delete;
 
-    // 设置线程池工作模式
+    // 设置线程池工作模式，仅RuntimeGrowthPolicy可设置
     void setMode(PoolMode mode = PoolMode::MODE_FIXED) {
         if(checkRunningState()) {
             // 不允许线程池启动后进行设置
             return;
         }
 
-        poolMode_ = mode;
+        if constexpr (GrowthPolicy::RUNTIME) {
+            poolMode_ = mode;
+        }
+        else if(mode != GrowthPolicy::MODE) {
+            LOG_WARN() << "setMode() ignored: pool mode is fixed by GrowthPolicy";
+        }
     }
 
-    // 定义任务队列中任务数量的上限值
+    // 定义任务队列中任务数量的上限值，至少为1
     void setTaskQueMaxThreshold(size_t threshold) {
         if(checkRunningState()) {
             // 不允许线程池启动后进行设置
             return;
         }
+        if(threshold == 0) {
+            // 上限为0时任何任务都无法入队，阻塞策略永远等待，丢弃最早任务的策略会从空队列出队
+            LOG_WARN() << "setTaskQueMaxThreshold() ignored: threshold must be positive";
+            return;
+        }
 
         taskQueMaxThreshold_ = threshold;
     }
 
+    // 定义任务队列占用内存的上限，单位：字节，0表示不限制
+    // 与任务数量上限同时生效，任一上限达到时按溢出策略处理；任务队列为空时总是接受任务，避免单个大任务永远无法提交
+    void setTaskQueMaxBytes(size_t bytes) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        taskQueMaxBytes_ = bytes;
+    }
+
+    // 设置任务队列已满时的溢出策略，timeout仅用于POLICY_TIMEOUT
+    // 默认为POLICY_TIMEOUT，等待1s
+    void setOverflowPolicy(OverflowPolicy policy, std::chrono::milliseconds timeout = std::chrono::seconds(1)) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        overflowPolicy_ = policy;
+        overflowTimeout_ = timeout;
+    }
+
+    // 开启基于排队时延的准入控制（CoDel），target为目标排队时延，0表示不开启
+    /*
+        - 任务数量上限无法约束时延：同样是1万个任务，慢任务的队列远比快任务的队列糟糕，
+          因此以任务的排队时延（出队时间 - 入队时间）而不是任务数量判断过载
+        - 排队时延持续interval都高于target（即interval内的最小排队时延高于target）时，
+          认为队列中存在无法消化的积压，开始拒绝新提交的PRIORITY_LOW任务，
+          被拒绝的任务通过future抛出TaskRejectedError
+        - 任一任务的排队时延低于target或任务队列被取空时，停止拒绝
+        - 瞬时突发在interval内即可消化，不会触发拒绝
+    */
+    void setAdmissionControl(std::chrono::microseconds target,
+                             std::chrono::microseconds interval = std::chrono::milliseconds(100)) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        admissionTarget_ = target;
+        admissionInterval_ = interval;
+    }
+
     // 定义线程池中线程数量的上限
     void setThreadSizeThreshold(size_t threadhold) {
         if(checkRunningState()) {
@@ -88,11 +428,173 @@ public:
             return;
         }
 
-        if(poolMode_ == PoolMode::MODE_CACHED) {
+        if(isMode(PoolMode::MODE_CACHED)) {
             threadSizeThreshold_ = threadhold;
         }
     }
 
+    // 设置工作线程的栈大小与栈保护区大小，单位：字节，0表示使用系统默认值
+    // cached模式下线程数量可达上千，减小栈大小可显著降低虚拟内存占用
+    void setThreadStack(size_t stackSize, size_t guardSize = 0) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        threadAttr_.stackSize = stackSize;
+        threadAttr_.guardSize = guardSize;
+    }
+
+    // 开启空闲栈释放：线程空闲超过STACK_RELEASE_IDLE_TIME后，将栈中未使用部分的物理内存交还给系统
+    void setIdleStackRelease(bool enabled) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        releaseIdleStack_ = enabled;
+    }
+
+    // 开启工作线程的性能计数器统计（cycles/instructions/LLC misses/上下文切换）
+    void setPerfCounterEnabled(bool enabled) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        perfCounterEnabled_ = enabled;
+    }
+
+    // 开启长时间运行任务的看门狗，threshold为任务执行时间的上限
+    // compensate为true时，fixed模式下为每个被标记的任务临时增加一个线程，使排队的任务继续执行，
+    // 被标记的任务结束后临时线程随即退出
+    void setWatchdog(std::chrono::milliseconds threshold, bool compensate = true) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        watchdogThreshold_ = threshold;
+        watchdogCompensate_ = compensate;
+    }
+
+    // 开启CPU配额跟随，fixed模式下每CPU_LIMIT_WATCH_INTERVAL检查一次cgroup CPU配额与CPU亲和性，
+    // 可用CPU数量变化时通过resize()调整线程数量，启动后线程数量即以可用CPU数量为准
+    void setCpuLimitWatch(bool enabled) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        cpuLimitWatch_ = enabled;
+    }
+
+    // 运行时调整fixed模式的线程数量
+    /*
+        - 增加时立即创建并启动新线程
+        - 减少时只记录需要退出的线程数量，工作线程在取下一个任务之前检查并自行退出，
+          正在执行的任务不受影响，队列中的任务既不丢弃也不改变顺序
+        - 看门狗补偿的临时线程不计入线程数量
+    */
+    void resize(size_t threadSize) {
+        SiteLock lock(taskQueMtx_);
+        if(!isPoolRunning_ || !isMode(PoolMode::MODE_FIXED) || threadSize == 0) {
+            // 仅允许fixed模式在线程池启动后调整
+            LOG_WARN() << "resize() requires a running pool in fixed mode and a positive size";
+            return;
+        }
+
+        // 当前不会退出的常驻线程数量
+        size_t current = curThreadSize_ - compensateThreadSize_ - retiringSize_;
+        initThreadSize_ = threadSize;
+
+        if(threadSize > current) {
+            // 优先撤销尚未完成的退出
+            size_t cancelled = std::min(retiringSize_, threadSize - current);
+            retiringSize_ -= cancelled;
+            current += cancelled;
+
+            for(; current < threadSize; ++current) {
+                addThread(threadNamePrefix_ + "-" + std::to_string(nextThreadIndex_++), false);
+            }
+        }
+        else if(threadSize < current) {
+            retiringSize_ += current - threadSize;
+
+            // 唤醒空闲线程与阻塞在轮询器上的线程检查是否需要退出
+            taskQueNotEmpty_.notify_all();
+            wakeupIdlePollers();
+        }
+
+        LOG_INFO() << "Resized pool to " << threadSize << " threads";
+    }
+
+    // 注册空闲轮询器，空闲的工作线程将阻塞在轮询器上并执行其I/O事件回调
+    // 轮询器需在线程池析构之前调用removeIdlePoller注销
+    void addIdlePoller(IdlePoller* poller) {
+        SiteLock lock(taskQueMtx_);
+        idlePollers_.push_back(IdlePollerSlot{ poller, false });
+
+        // 唤醒一个空闲线程占用新的轮询器
+        taskQueNotEmpty_.notify_one();
+    }
+
+    // 注销空闲轮询器，若有工作线程正在其上阻塞，则等待该线程返回
+    void removeIdlePoller(IdlePoller* poller) {
+        SiteLock lock(taskQueMtx_);
+        auto it = std::find_if(idlePollers_.begin(), idlePollers_.end(), [&](const IdlePollerSlot& slot) {
+            return slot.poller == poller;
+        });
+        if(it == idlePollers_.end()) {
+            return;
+        }
+
+        // 先标记为正在注销，避免其它线程再次占用
+        it->removing = true;
+        while(it->claimed) {
+            poller->wakeup();
+            pollerReleased_.wait(lock);
+            it = std::find_if(idlePollers_.begin(), idlePollers_.end(), [&](const IdlePollerSlot& slot) {
+                return slot.poller == poller;
+            });
+        }
+        idlePollers_.erase(it);
+    }
+
+    // 设置异步文件I/O的实现方式
+    void setFileIoMode(FileIoMode mode) {
+        if(checkRunningState()) {
+            // 不允许线程池启动后进行设置
+            return;
+        }
+
+        fileIoMode_ = mode;
+    }
+
+    // 异步读取文件，不占用工作线程等待I/O，返回读取的字节数
+    // 基于io_uring时，完成事件由异步文件I/O的完成线程收割，在工作线程中等待结果不依赖其它空闲线程
+    // 返回的TaskFuture在请求完成时触发完成通知，可用于onComplete/when_all/when_any
+    TaskFuture<ssize_t> asyncRead(int fd, void* buffer, size_t size, off_t offset) {
+        return fileIO().read(fd, buffer, size, offset);
+    }
+
+    // 异步写入文件，返回写入的字节数
+    TaskFuture<ssize_t> asyncWrite(int fd, const void* buffer, size_t size, off_t offset) {
+        return fileIO().write(fd, buffer, size, offset);
+    }
+
+    // 获取所有工作线程的性能计数器快照
+    // 已回收线程的记录超过MAX_PERF_RECORDS时合并为一条名为"exited"的记录，总计数保持不变
+    std::vector<PerfSnapshot> getPerfSnapshot() {
+        std::lock_guard<std::mutex> lock(perfMtx_);
+        std::vector<PerfSnapshot> snapshots;
+        snapshots.reserve(perfRecords_.size());
+        for(auto& record : perfRecords_) {
+            snapshots.emplace_back(record->snapshot());
+        }
+        return snapshots;
+    }
+
     // 提交任务（生产者，向任务队列中提交任务）
     // 使用可变参模板编程，可接收任意任务函数与任意数量的参数
     // 将提交的任意任务统一封装成线程池可处理的void()类型任务，同时保证任务执行和返回值获取的安全性。这是实现线程池任务调度机制的经典模式
@@ -100,56 +602,159 @@ public:
         任务提交 --> 任务包装 --> 队列存储
     */
     template<typename taskFunc, typename... Args>
-    auto submitTask(taskFunc&& func, Args&&... args) -> std::future<decltype(func(args...))> {
+    auto submitTask(taskFunc&& func, Args&&... args) -> TaskFuture<decltype(func(args...))> {
+        return submitTask(TaskSite{}, std::forward<taskFunc>(func), std::forward<Args>(args)...);
+    }
+
+    // 提交任务并记录提交位置，例如：pool.submitTask(TASK_SITE("flush"), func, args...)
+    template<typename taskFunc, typename... Args>
+    auto submitTask(const TaskSite& site, taskFunc&& func, Args&&... args) -> TaskFuture<decltype(func(args...))> {
+        TaskOptions options;
+        options.site = site;
+        return submitTask(options, std::forward<taskFunc>(func), std::forward<Args>(args)...);
+    }
+
+    // 以指定优先级提交任务，例如：pool.submitTask(TaskPriority::PRIORITY_LOW, func, args...)
+    template<typename taskFunc, typename... Args>
+    auto submitTask(TaskPriority priority, taskFunc&& func, Args&&... args) -> TaskFuture<decltype(func(args...))> {
+        TaskOptions options;
+        options.priority = priority;
+        return submitTask(options, std::forward<taskFunc>(func), std::forward<Args>(args)...);
+    }
+
+    // 以完整选项提交任务，例如：
+    //     TaskOptions options;
+    //     options.payloadBytes = buffer.size();
+    //     pool.submitTask(options, [buffer = std::move(buffer)]() { ... });
+    template<typename taskFunc, typename... Args>
+    auto submitTask(const TaskOptions& options, taskFunc&& func, Args&&... args) -> TaskFuture<decltype(func(args...))> {
         // 推导返回值类型
         // 基于具体表达式的编译时类型推导
         using retType = decltype(func(args...));
 
+        const TaskSite& site = options.site;
+        TaskPriority priority = options.priority;
+
+        // 绑定任务函数与参数
+        auto bound = std::bind(std::forward<taskFunc>(func), std::forward<Args>(args)...);
+
+        // 任务在队列中占用的内存：闭包与包装对象的大小，加上调用方声明的堆上数据大小
+        size_t taskBytes = sizeof(PackagedTask<retType, decltype(bound)>) + sizeof(TaskItem) + options.payloadBytes;
+
         // 任务包装
         // 使用std::shared_ptr确保std::packaged_task在任务执行完毕前不会被销毁
-        auto task = std::make_shared<std::packaged_task<retType()>>(
-            std::bind(std::forward<taskFunc>(func), std::forward<Args>(args)...)
-        );
-
-        // 获取任务返回值
-        std::future<retType> result = task->get_future();
+        auto task = std::make_shared<PackagedTask<retType, decltype(bound)>>(std::move(bound));
 
-        // 获取锁
-        std::unique_lock<std::mutex> lock(taskQueMtx_);
+        // 获取任务返回值，完成通知与任务包装共享同一块内存；任务函数执行后即销毁，future只延长包装本身的生命周期
+        TaskFuture<retType> result(task->task.get_future(), std::shared_ptr<TaskCompletion>(task, &task->completion));
 
-        // 等待任务队列未满，含超时判断机制，防止submitTask的调用线程一直阻塞
-        if(!taskQueNotFull_.wait_for(lock, std::chrono::seconds(1), [&]()->bool{
-            return taskQue_.size() < taskQueMaxThreshold_;
-        })) {
-            // 判定超时，任务提交失败
-            LOG_INFO() << "Task queue is full, submit task timed out";
+        // 开启追踪时为任务分配追踪id，未开启时为0
+        uint64_t traceId = 0;
+        if(Tracer::isEnabled()) {
+            traceId = Tracer::nextId();
+            Tracer::flowBegin("submit", "task", traceId);
+        }
 
-            auto task = std::make_shared<std::packaged_task<retType()>>(
-                []()->retType{ return retType(); }
-            );
+        // 获取锁
+        SiteLock lock(taskQueMtx_);
+
+        // 以异常结束任务，调用方从future中获取
+        // 完成回调可能再次提交任务，释放锁后再结束任务
+        auto reject = [&](const char* reason) {
+            LOG_INFO() << "Task rejected: " << reason;
+            lock.unlock();
+            task->rejected = std::make_exception_ptr(TaskRejectedError(reason));
+            task->run();
+        };
+
+        // 溢出策略丢弃的任务，释放锁后再结束
+        std::vector<TaskItem> dropped;
+
+        // 开启准入控制时，以队头任务已等待的时间更新过载状态，积压时拒绝低优先级任务
+        if(admissionTarget_.count() > 0) {
+            if(!taskQue_.empty()) {
+                auto now = std::chrono::steady_clock::now();
+                updateAdmission(now - taskQue_.front().enqueueTime, now);
+            }
 
-            (*task)();
+            if(shedding_ && priority == TaskPriority::PRIORITY_LOW) {
+                statsCollector_.onShed();
+                reject("task shed: queue delay exceeds admission target");
+                return result;
+            }
+        }
 
-            // 返回当前类型的0值
-            return task->get_future();
+        // 任务队列已满（任务数量或内存预算）时按溢出策略处理
+        if(isQueueFull(taskBytes)) {
+            auto notFull = [&]()->bool{
+                return !isQueueFull(taskBytes);
+            };
+
+            switch(overflowPolicy_) {
+            case OverflowPolicy::POLICY_BLOCK:
+                taskQueNotFull_.wait(lock, notFull);
+                break;
+            case OverflowPolicy::POLICY_TIMEOUT:
+                // 等待任务队列未满，含超时判断机制，防止submitTask的调用线程一直阻塞
+                if(!taskQueNotFull_.wait_for(lock, overflowTimeout_, notFull)) {
+                    statsCollector_.onRejected();
+                    reject("submit task timed out: task queue is full");
+                    return result;
+                }
+                break;
+            case OverflowPolicy::POLICY_FAIL_FAST:
+                statsCollector_.onRejected();
+                reject("task queue is full");
+                return result;
+            case OverflowPolicy::POLICY_CALLER_RUNS:
+                // 释放锁后在提交线程上执行，生产者因此自然减速
+                lock.unlock();
+                statsCollector_.onCallerRuns();
+                {
+                    ForeignScope foreignScope(this);
+                    TaskScope scope(workerContext());
+                    task->run();
+                }
+                return result;
+            case OverflowPolicy::POLICY_DROP_OLDEST:
+                // 内存预算不足时可能需要丢弃多个任务，队列为空时总能接受任务
+                while(!taskQue_.empty() && isQueueFull(taskBytes)) {
+                    dropped.emplace_back(dropOldestTask());
+                }
+                break;
+            }
         }
 
         // 若队列未满，则向任务队列中添加任务
-        // 通过lambda将std::packaged_task二次封装为void()类型的任务，通过lambda包装实现了类型擦除
-        // 将用户提交的任务（函数 + 参数）封装成一个无参数、无返回值的Task对象，并放入线程池的任务队列中，等待工作线程取出执行
-        taskQue_.emplace([task](){
-            (*task)();
+        // 通过lambda将std::packaged_task二次封装为Task类型的任务，通过lambda包装实现了类型擦除
+        // 将用户提交的任务（函数 + 参数）封装成一个无返回值的Task对象，并放入线程池的任务队列中，等待工作线程取出执行
+        taskQue_.emplace(TaskItem{
+            [task](std::exception_ptr rejected){
+                task->rejected = rejected;
+                task->run();
+            },
+            std::chrono::steady_clock::now(),
+            traceId,
+            site,
+            taskBytes
         });
 
         // 任务数量+1
         taskSize_++;
+        queueBytes_ += taskBytes;
+        statsCollector_.onEnqueue();
 
         // 通知其它线程任务队列不为空
         taskQueNotEmpty_.notify_all();
 
+        // 等待任务的空闲线程不足时，唤醒阻塞在轮询器上的线程
+        if(pollingSize_ > 0 && taskSize_ + pollingSize_ > idleThreadSize_) {
+            wakeupIdlePollers();
+        }
+
         // cached模式下，根据任务数量和空闲线程的数量，判断是否需要创建新的线程
         if(
-            poolMode_ == PoolMode::MODE_CACHED &&   // cached模式
+            isMode(PoolMode::MODE_CACHED) &&        // cached模式
             taskSize_ > idleThreadSize_  &&         // 任务队列中的任务数量大于空闲线程的数量
             curThreadSize_ < threadSizeThreshold_   // 线程池中线程数量小于上限值
         ) 
@@ -157,23 +762,26 @@ public:
             // 生成新线程名称
             std::string threadName = "CachedThread-" + std::to_string(curThreadSize_);
 
-            // 创建新线程
-            auto obj = std::make_unique<Thread>(
-                std::bind(&ThreadPool::threadFunc, this, std::placeholders::_1), 
-                threadName
-            );
-            int threadId = obj->getId();
-            threads_.emplace(threadId, std::move(obj));
-
-            // 启动新的线程
-            threads_[threadId]->start();
+            // 创建并启动新线程
+            addThread(threadName, false);
+            statsCollector_.onThreadSpawned();
 
-            curThreadSize_++;
-            idleThreadSize_++;
+            // 线程数量增加后，已到截止时间的空闲线程可能变为可回收
+            reaperCond_.notify_one();
+            if(Tracer::isEnabled()) {
+                Tracer::instant("spawn", "thread");
+            }
 
             LOG_INFO() << "Created new thread: " << threadName;
         }
 
+        if(!dropped.empty()) {
+            lock.unlock();
+            for(auto& item : dropped) {
+                item.task(std::make_exception_ptr(TaskRejectedError("task dropped: task queue is full")));
+            }
+        }
+
         return result;
     }
 
@@ -185,6 +793,8 @@ public:
         // 初始线程个数
         initThreadSize_ = initThreadSize;
         curThreadSize_ = initThreadSize;
+        threadNamePrefix_ = threadNamePrefix;
+        nextThreadIndex_ = initThreadSize;
 
         // 创建线程对象
         for(size_t i = 0; i < initThreadSize_; ++i) {
@@ -193,7 +803,7 @@ public:
 
             // 创建Thread线程对象时，将线程执行函数给到创建的Thread对象
             auto obj = std::make_unique<Thread>(
-                std::bind(&ThreadPool::threadFunc, this, std::placeholders::_1), 
+                std::bind(&BasicThreadPool::threadFunc, this, std::placeholders::_1, false), 
                 threadName
             );
             int threadId = obj->getId();
@@ -201,36 +811,186 @@ public:
         }
 
         // 启动所有线程
-        for(size_t i = 0; i < initThreadSize_; ++i) {
-            threads_[i]->start();
-
+        // 线程id全局递增，同一进程中创建多个线程池时不从0开始，因此遍历线程容器而不是按下标访问
+        for(auto& item : threads_) {
             idleThreadSize_++;          // 记录空闲线程的数量
+            workerContexts_++;
+
+            item.second->start(threadAttr_);
         }
 
         LOG_INFO() << "Created " << initThreadSize << " initial threads with prefix: " << threadNamePrefix;
+
+        // cached模式下启动回收线程
+        if(isMode(PoolMode::MODE_CACHED)) {
+            reaperThread_ = std::thread(&BasicThreadPool::reaperFunc, this);
+        }
+
+        // 启动看门狗线程
+        if(watchdogThreshold_.count() > 0) {
+            watchdogThread_ = std::thread(&BasicThreadPool::watchdogFunc, this);
+        }
+
+        // fixed模式下启动CPU配额跟随线程
+        if(cpuLimitWatch_ && isMode(PoolMode::MODE_FIXED)) {
+            cpuLimitThread_ = std::thread(&BasicThreadPool::cpuLimitWatchFunc, this);
+        }
+    }
+
+    // 在调用线程上以本线程池任务的身份执行func并返回其结果，供TaskGroup等组件在等待线程上直接执行组内任务
+    // func执行期间可以使用local()/scratchArena()，临时内存区在func结束后回退或重置
+    template<typename Func>
+    auto runInline(Func&& func) -> decltype(func()) {
+        ForeignScope foreignScope(this);
+        TaskScope scope(workerContext());
+        return func();
+    }
+
+    // 在调用线程上执行任务队列中的一个任务，任务队列为空时返回false
+    // 供TaskGroup等在工作线程中等待的组件协助执行任务，避免工作线程因等待而阻塞
+    bool runPendingTask() {
+        TaskItem item;
+        {
+            SiteLock lock(taskQueMtx_);
+            if(taskQue_.empty()) {
+                return false;
+            }
+
+            item = std::move(taskQue_.front());
+            taskQue_.pop();
+            taskSize_--;
+            queueBytes_ -= item.bytes;
+            onAdmissionDequeue(item);
+
+            // 通知生产者任务队列未满
+            taskQueNotFull_.notify_all();
+        }
+
+        execTask(item);
+        return true;
+    }
+
+    // 获取线程池运行时统计快照
+    PoolStats stats() {
+        PoolStats stats;
+        stats.queueDepth = taskSize_;
+        stats.curThreadSize = curThreadSize_;
+        stats.idleThreadSize = idleThreadSize_;
+        stats.compensateThreadSize = compensateThreadSize_;
+        stats.shedding = shedding_;
+        stats.queueBytes = queueBytes_;
+        stats.queueMaxBytes = taskQueMaxBytes_;
+        statsCollector_.fill(stats);
+        return stats;
+    }
+
+    // 获取线程池中当前线程的数量
+    size_t getThreadSize() const {
+        return curThreadSize_;
+    }
+
+    // 判断当前线程是否为本线程池的工作线程
+    bool isInPoolThread() const {
+        return currentPool_ == this;
+    }
+
+    // 获取当前工作线程的T实例，首次调用时以args构造，工作线程退出时析构
+    // 同一工作线程上的任务依次复用该实例，可保存压缩字典、解析缓冲区等需要跨任务保留的状态；
+    // 按类型区分实例，同类型的不同用途应各自包装为独立的结构体；
+    // 非本线程池工作线程（POLICY_CALLER_RUNS的提交线程、协助执行的等待线程）只能在执行本线程池任务期间调用，
+    // 返回的实例在最外层任务结束后析构，不会保留到下一个任务；在任务之外调用时抛出std::logic_error
+    template<typename T, typename... Args>
+    T& local(Args&&... args) {
+        auto& locals = workerContext().locals;
+        auto it = locals.find(std::type_index(typeid(T)));
+        if(it == locals.end()) {
+            it = locals.emplace(std::type_index(typeid(T)), std::make_shared<T>(std::forward<Args>(args)...)).first;
+        }
+        return *static_cast<T*>(it->second.get());
+    }
+
+    // 获取当前任务的临时内存区，作为std::pmr容器的内存资源
+    // 任务结束后内存整体回收，只能在任务执行期间使用，分配的对象不能在任务结束后继续访问；
+    // 非工作线程在任务之外调用时抛出std::logic_error
+    ScratchArena& scratchArena() {
+        return workerContext().arena;
     }
 
 private:
-    // 定义线程执行函数，消费者，不断从任务队列中获取任务
-    void threadFunc(size_t threadId) {
+    // 定义线程执行函数
+    // 工作线程局部对象与任务临时内存区在工作循环退出、释放锁之后析构，析构完成后析构函数才能返回
+    void threadFunc(size_t threadId, bool isCompensating) {
+        {
+            WorkerContext context;
+            currentContext_ = &context;
+            workerLoop(threadId, isCompensating);
+        }
+        currentContext_ = nullptr;
+
+        // 通知析构函数中的wait
+        SiteLock lock(taskQueMtx_);
+        workerContexts_--;
+        exitCond_.notify_all();
+    }
+
+    // 工作循环，消费者，不断从任务队列中获取任务
+    // isCompensating表示该线程是看门狗为长时间运行任务补偿的临时线程
+    void workerLoop(size_t threadId, bool isCompensating) {
         // 获取当前线程名称
         auto&& thread = threads_[threadId];
         LOG_INFO() << "Thread " << thread->getName() << " started";
 
+        // 标记当前线程所属的线程池
+        currentPool_ = this;
+        Tracer::setThreadName(thread->getName());
+
+        // 注册当前线程的统计记录
+        auto workerStats = statsCollector_.registerWorker(thread->getName());
+        currentWorkerStats_ = workerStats.get();
+
+        // 按需为当前线程打开性能计数器
+        std::unique_ptr<PerfProbe> perfProbe;
+        if(perfCounterEnabled_) {
+            // 探针构造时写入各事件是否可用，构造完成后再发布记录，快照接口读取时不会与之竞争
+            auto record = std::make_shared<PerfRecord>(thread->getName());
+            perfProbe = std::make_unique<PerfProbe>(record);
+            registerPerfRecord(std::move(record));
+        }
+        currentPerfProbe_ = perfProbe.get();
+
         // 记录当前时间
-        auto lastTime = std::chrono::high_resolution_clock().now();
+        auto lastTime = std::chrono::steady_clock::now();
+
+        // 本次空闲的回收截止时间，仅cached模式使用
+        IdleDeadline idleDeadline;
+        bool deadlineAdded = false;
+
+        // 本次空闲期间是否已释放栈内存
+        bool stackReleased = false;
+
+        // 本次空闲期间是否已自旋等待
+        bool spun = false;
 
         // 线程不断循环，从任务队列中取出任务
         // 等待所有任务执行完成后，才可以回收线程池资源
         for(;;) {
-            Task task;
+            TaskItem item;
             {
                 // 获取锁
-                std::unique_lock<std::mutex> lock(taskQueMtx_);
+                SiteLock lock(taskQueMtx_);
 
                 LOG_INFO() << "Thread " << thread->getName() << " attempting to get task...";
 
+                // 被标记的任务结束后回收多余的补偿线程，线程数量调小后回收多余的常驻线程
+                if(isCompensating ? retireCompensateThread(threadId) : retireSurplusThread(threadId)) {
+                    return;
+                }
+
                 while(taskQue_.size() == 0) {
+                    if(isCompensating ? retireCompensateThread(threadId) : retireSurplusThread(threadId)) {
+                        return;
+                    }
+
                     if(!isPoolRunning_) {
                         //// 回收线程池资源
                         LOG_INFO() << "Thread " << thread->getName() << " exiting";
@@ -238,55 +998,122 @@ private:
                         // 回收当前线程，将线程对象从线程容器中删除
                         threads_.erase(threadId);
 
+                        statsCollector_.onWorkerExit(currentWorkerStats_);
+                        currentPerfProbe_ = nullptr;
+
                         // 通知析构函数中的wait
                         exitCond_.notify_all();
                         
                         return;
                     }
 
-                    // cached模式下，线程空闲时间超过60s，则回收空闲的线程
-                    // 超过initThreadSize_数量的线程需要进行超时回收
-                    if(poolMode_ == PoolMode::MODE_CACHED) {
-                        if(std::cv_status::timeout == taskQueNotEmpty_.wait_for(lock, std::chrono::seconds(1))) {
-                            // 条件变量超时返回
-                            // 获取当前时间
-                            auto nowTime = std::chrono::high_resolution_clock().now();
-                            auto duration = std::chrono::duration_cast<std::chrono::seconds>(nowTime - lastTime).count();
-                            if(
-                                duration >= THREAD_MAX_IDLE_TIME &&     // 60s超时
-                                curThreadSize_ > initThreadSize_        // 线程池中的线程数量大于线程初始数量
-                            ) {
-                                LOG_INFO() << "Thread " << thread->getName() << " timed out and exiting";
-
-                                // 回收当前线程，将线程对象从线程容器中删除
-                                threads_.erase(threadId);
-                                
-                                curThreadSize_--;
-                                idleThreadSize_--;
-
-                                return;
-                            }
+                    // 回收线程已决定回收当前线程
+                    if(deadlineAdded && reapedThreads_.count(threadId) > 0) {
+                        LOG_INFO() << "Thread " << thread->getName() << " timed out and exiting";
+
+                        reapedThreads_.erase(threadId);
+
+                        // 回收当前线程，将线程对象从线程容器中删除
+                        threads_.erase(threadId);
+
+                        curThreadSize_--;
+                        idleThreadSize_--;
+                        statsCollector_.onThreadReaped();
+                        statsCollector_.onWorkerExit(currentWorkerStats_);
+                        currentPerfProbe_ = nullptr;
+                        if(Tracer::isEnabled()) {
+                            Tracer::instant("reap", "thread");
+                        }
+
+                        // 析构函数可能正在等待线程退出
+                        exitCond_.notify_all();
+
+                        return;
+                    }
+
+                    // 存在未被占用的轮询器时，阻塞在轮询器上等待I/O事件，事件回调在当前线程上执行
+                    if(IdlePoller* poller = claimIdlePoller()) {
+                        // 处理I/O事件不算空闲，撤销回收截止时间，返回后重新登记
+                        if(deadlineAdded) {
+                            removeIdleDeadline(idleDeadline);
+                            deadlineAdded = false;
+                        }
+
+                        // 轮询器抛出的异常不能越过工作循环，否则工作线程终止且轮询器一直处于占用状态
+                        lock.unlock();
+                        try {
+                            poller->poll(IDLE_POLL_TIMEOUT);
+                        }
+                        catch(const std::exception& e) {
+                            LOG_ERROR() << "Idle poller threw: " << e.what();
+                        }
+                        catch(...) {
+                            LOG_ERROR() << "Idle poller threw an unknown exception";
+                        }
+                        lock.lock();
+                        releaseIdlePoller(poller);
+
+                        lastTime = std::chrono::steady_clock::now();
+                        continue;
+                    }
+
+                    // cached模式下，登记本次空闲的回收截止时间，由回收线程按截止时间顺序回收
+                    if(isMode(PoolMode::MODE_CACHED) && !deadlineAdded) {
+                        idleDeadline = IdleDeadline(lastTime + std::chrono::seconds(THREAD_MAX_IDLE_TIME), threadId);
+                        addIdleDeadline(idleDeadline);
+                        deadlineAdded = true;
+                    }
+
+                    // 自旋等待策略下，每次空闲先自旋一次，仍无任务时再阻塞
+                    if constexpr (IdlePolicy::SPIN_US > 0) {
+                        if(!spun) {
+                            spun = true;
+                            lock.unlock();
+                            spinForTask();
+                            lock.lock();
+                            continue;
+                        }
+                    }
+
+                    if(releaseIdleStack_ && !stackReleased) {
+                        // 空闲超过STACK_RELEASE_IDLE_TIME仍无任务时释放栈内存，系统调用期间不持有锁
+                        if(std::cv_status::timeout == taskQueNotEmpty_.wait_for(lock, std::chrono::seconds(STACK_RELEASE_IDLE_TIME))) {
+                            stackReleased = true;
+                            lock.unlock();
+                            Thread::releaseUnusedStack();
+                            lock.lock();
                         }
                     }
                     else {
-                        // 等待任务队列不为空
+                        // 等待任务队列不为空，空闲线程无限期等待，超时回收由回收线程负责
                         // 在循环中检查条件，防止虚假唤醒
                         taskQueNotEmpty_.wait(lock);
                     }
                 }
 
+                // 撤销回收截止时间，即使回收线程已决定回收当前线程，有任务时也继续执行
+                if(deadlineAdded) {
+                    removeIdleDeadline(idleDeadline);
+                    deadlineAdded = false;
+                }
+
+                stackReleased = false;
+                spun = false;
+
                 // 线程准备处理任务，线程空闲数量减1
                 idleThreadSize_--;
 
                 LOG_INFO() << "Thread " << thread->getName() << " get task success";
 
                 // 从任务队列的队头取出任务
-                task = taskQue_.front();
+                item = std::move(taskQue_.front());
                 // 出队
                 taskQue_.pop();
 
                 // 任务数-1
                 taskSize_--;
+                queueBytes_ -= item.bytes;
+                onAdmissionDequeue(item);
 
                 // 若任务队列中仍然有任务，通知其它消费者从任务队列中取任务
                 // 不仅让生产者通知消费者，也让消费者之间相互通知
@@ -299,12 +1126,8 @@ private:
             }
 
             // 当前线程执行该任务
-            if(task != nullptr) {  
-                LOG_INFO() << "Thread " << thread->getName() << " executing task";
-
-                // 检查函数包装器是否为空，即未绑定任何可调用对象
-                task();
-            }
+            LOG_INFO() << "Thread " << thread->getName() << " executing task";
+            execTask(item);
 
             // 线程任务完成，线程空闲数量加1
             idleThreadSize_++;
@@ -312,7 +1135,423 @@ private:
             LOG_INFO() << "Thread " << thread->getName() << " task completed";
 
             // 更新时间
-            lastTime = std::chrono::high_resolution_clock::now();
+            lastTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    // 当前线程在本线程池中的上下文
+    // 工作线程使用线程自己的上下文；非工作线程只在执行本线程池的任务期间拥有上下文，其它时候抛出std::logic_error
+    WorkerContext& workerContext() {
+        if(isInPoolThread()) {
+            return *currentContext_;
+        }
+
+        WorkerContext* context = findForeignContext();
+        if(context == nullptr) {
+            throw std::logic_error("local()/scratchArena() must be called from a task running on this pool");
+        }
+        return *context;
+    }
+
+    // 查找当前非工作线程正在执行的本线程池任务的上下文，嵌套执行其它线程池的任务时沿作用域链查找
+    WorkerContext* findForeignContext() const {
+        for(ForeignScope* scope = foreignScope_; scope != nullptr; scope = scope->previous_) {
+            if(scope->pool_ == this) {
+                return &*scope->context_;
+            }
+        }
+        return nullptr;
+    }
+
+    // 发布工作线程的性能计数记录
+    // 记录数量达到上限时，将已回收线程的记录合并到"exited"记录中，cached模式反复扩容/回收时记录数量保持有界
+    void registerPerfRecord(std::shared_ptr<PerfRecord> record) {
+        std::lock_guard<std::mutex> lock(perfMtx_);
+        if(perfRecords_.size() >= MAX_PERF_RECORDS) {
+            if(!exitedPerfRecord_) {
+                exitedPerfRecord_ = std::make_shared<PerfRecord>("exited");
+                perfRecords_.insert(perfRecords_.begin(), exitedPerfRecord_);
+            }
+            perfRecords_.erase(std::remove_if(perfRecords_.begin(), perfRecords_.end(), [&](const std::shared_ptr<PerfRecord>& r) {
+                if(!r->exited.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                exitedPerfRecord_->merge(*r);
+                return true;
+            }), perfRecords_.end());
+        }
+        perfRecords_.emplace_back(std::move(record));
+    }
+
+    // 执行一个已出队的任务，并记录统计、性能计数器与追踪事件
+    void execTask(TaskItem& item) {
+        // 检查函数包装器是否为空，即未绑定任何可调用对象
+        if(item.task == nullptr) {
+            return;
+        }
+
+        // 其它线程池的工作线程协助执行时，不计入其线程记录
+        bool inPoolThread = isInPoolThread();
+        typename StatsPolicy::WorkerRecord* workerStats = inPoolThread ? currentWorkerStats_ : nullptr;
+
+        // 等待中协助执行的嵌套任务计入最外层任务，线程忙碌时间与性能计数器只按最外层任务统计
+        ForeignScope foreignScope(this);
+        WorkerContext& context = workerContext();
+        bool outermost = context.taskDepth == 0;
+        PerfProbe* perfProbe = inPoolThread && outermost ? currentPerfProbe_ : nullptr;
+
+        // 关闭统计时不读取时间
+        std::chrono::steady_clock::time_point beginTime;
+        if constexpr (StatsPolicy::ENABLED) {
+            beginTime = std::chrono::steady_clock::now();
+            statsCollector_.onDequeue(item.enqueueTime, beginTime);
+        }
+
+        // 开启看门狗时记录工作线程当前执行的任务，嵌套执行的任务计入最外层任务
+        bool watched = workerStats != nullptr && watchdogThreshold_.count() > 0 &&
+                       workerStats->runState.load(std::memory_order_relaxed) == 0;
+        if(watched) {
+            statsCollector_.onTaskBegin(workerStats, beginTime, item.site.label, item.site.file, item.site.line);
+        }
+
+        // 追踪id仅在提交时开启了追踪才不为0
+        uint64_t traceBegin = 0;
+        if(item.traceId != 0) {
+            traceBegin = Tracer::now();
+            Tracer::instant("dequeue", "task", item.traceId);
+            Tracer::flowEnd("submit", "task", item.traceId, traceBegin);
+        }
+
+        if(perfProbe) {
+            perfProbe->taskBegin();
+        }
+
+        {
+            TaskScope scope(context);
+            item.task(nullptr);
+        }
+
+        if(perfProbe) {
+            perfProbe->taskEnd();
+        }
+
+        if(item.traceId != 0) {
+            Tracer::complete("execute", "task", traceBegin, Tracer::now(), item.traceId);
+        }
+
+        // 被标记的任务结束，唤醒可能需要退出的补偿线程
+        if(watched && statsCollector_.onTaskEnd(workerStats)) {
+            SiteLock lock(taskQueMtx_);
+            flaggedRunning_--;
+            taskQueNotEmpty_.notify_all();
+        }
+
+        if constexpr (StatsPolicy::ENABLED) {
+            statsCollector_.onExecuted(workerStats, beginTime, std::chrono::steady_clock::now(), !outermost);
+        }
+    }
+
+    // 自旋等待任务入队，超过IdlePolicy::SPIN_US后返回，调用时不持有taskQueMtx_
+    void spinForTask() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(IdlePolicy::SPIN_US);
+        while(taskSize_ == 0 && isPoolRunning_ && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    // 创建并启动新线程，调用时需持有taskQueMtx_
+    void addThread(const std::string& threadName, bool isCompensating) {
+        auto obj = std::make_unique<Thread>(
+            std::bind(&BasicThreadPool::threadFunc, this, std::placeholders::_1, isCompensating), 
+            threadName
+        );
+        int threadId = obj->getId();
+        threads_.emplace(threadId, std::move(obj));
+
+        // 启动新的线程
+        threads_[threadId]->start(threadAttr_);
+
+        curThreadSize_++;
+        idleThreadSize_++;
+        workerContexts_++;
+    }
+
+    // 补偿线程多于仍在运行的被标记任务时，回收当前补偿线程，调用时需持有taskQueMtx_
+    bool retireCompensateThread(size_t threadId) {
+        if(compensateThreadSize_ <= flaggedRunning_) {
+            return false;
+        }
+
+        LOG_INFO() << "Thread " << threads_[threadId]->getName() << " no longer needed and exiting";
+
+        // 回收当前线程，将线程对象从线程容器中删除
+        threads_.erase(threadId);
+
+        curThreadSize_--;
+        idleThreadSize_--;
+        compensateThreadSize_--;
+        statsCollector_.onWorkerExit(currentWorkerStats_);
+        currentPerfProbe_ = nullptr;
+
+        // 析构函数可能正在等待线程退出
+        exitCond_.notify_all();
+        return true;
+    }
+
+    // resize()调小线程数量后，回收当前常驻线程，调用时需持有taskQueMtx_
+    bool retireSurplusThread(size_t threadId) {
+        if(retiringSize_ == 0) {
+            return false;
+        }
+
+        LOG_INFO() << "Thread " << threads_[threadId]->getName() << " retired by resize";
+
+        // 回收当前线程，将线程对象从线程容器中删除
+        threads_.erase(threadId);
+
+        curThreadSize_--;
+        idleThreadSize_--;
+        retiringSize_--;
+        statsCollector_.onWorkerExit(currentWorkerStats_);
+        currentPerfProbe_ = nullptr;
+
+        // 析构函数可能正在等待线程退出
+        exitCond_.notify_all();
+        return true;
+    }
+
+    // CPU配额跟随线程，可用CPU数量变化时调整线程数量
+    void cpuLimitWatchFunc() {
+        Tracer::setThreadName("CpuLimitWatch");
+
+        size_t lastLimit = 0;
+        std::unique_lock<std::mutex> lock(cpuLimitMtx_);
+        for(;;) {
+            size_t limit = detectCpuLimit();
+            if(limit != lastLimit) {
+                LOG_INFO() << "Available CPUs changed to " << limit;
+                lastLimit = limit;
+
+                lock.unlock();
+                resize(limit);
+                lock.lock();
+            }
+
+            if(cpuLimitCond_.wait_for(lock, std::chrono::milliseconds(CPU_LIMIT_WATCH_INTERVAL),
+                                      [&]()->bool{ return !isPoolRunning_; })) {
+                return;
+            }
+        }
+    }
+
+    // 看门狗线程，周期性检查各工作线程当前任务的执行时间
+    void watchdogFunc() {
+        Tracer::setThreadName("Watchdog");
+
+        // 检查周期为阈值的1/4，被标记的时间最多比阈值晚25%
+        auto interval = std::max<std::chrono::milliseconds>(watchdogThreshold_ / 4, std::chrono::milliseconds(1));
+
+        std::unique_lock<std::mutex> lock(watchdogMtx_);
+        for(;;) {
+            if(watchdogCond_.wait_for(lock, interval, [&]()->bool{ return !isPoolRunning_; })) {
+                return;
+            }
+
+            // 标记超时的任务
+            statsCollector_.flagLongTasks(std::chrono::steady_clock::now(), watchdogThreshold_, flaggedRunning_,
+                [&](const typename StatsPolicy::WorkerRecord& record) {
+                    const char* label = record.siteLabel.load(std::memory_order_relaxed);
+                    const char* file = record.siteFile.load(std::memory_order_relaxed);
+                    LOG_WARN() << "Thread " << record.threadName << " running task longer than "
+                               << watchdogThreshold_.count() << "ms"
+                               << " [" << (label ? label : "unlabeled") << "] "
+                               << (file ? file : "unknown") << ":" << record.siteLine.load(std::memory_order_relaxed);
+                });
+
+            // fixed模式下为被标记的任务补偿临时线程
+            if(watchdogCompensate_ && isMode(PoolMode::MODE_FIXED)) {
+                compensateLongTasks();
+            }
+        }
+    }
+
+    // 被标记的任务占用了工作线程且队列中有任务在等待时，补充临时线程
+    void compensateLongTasks() {
+        SiteLock lock(taskQueMtx_);
+        while(
+            isPoolRunning_ &&
+            compensateThreadSize_ < flaggedRunning_ &&      // 补偿线程少于被标记的任务
+            taskSize_ > idleThreadSize_ &&                  // 任务队列中的任务数量大于空闲线程的数量
+            curThreadSize_ < THREAD_MAX_THRESHOLD           // 线程池中线程数量小于上限值
+        ) 
+        {
+            std::string threadName = "CompensateThread-" + std::to_string(compensateThreadSize_);
+            compensateThreadSize_++;
+            addThread(threadName, true);
+
+            LOG_INFO() << "Created compensating thread: " << threadName;
+        }
+    }
+
+    // 首次使用时创建异步文件I/O
+    AsyncFileIO& fileIO() {
+        std::call_once(fileIoOnce_, [&]() {
+            fileIO_ = std::make_unique<AsyncFileIO>(fileIoMode_);
+        });
+        return *fileIO_;
+    }
+
+    // 判断任务队列能否再容纳一个占用bytes字节的任务，调用时需持有taskQueMtx_
+    bool isQueueFull(size_t bytes) const {
+        if(taskQue_.size() >= taskQueMaxThreshold_) {
+            return true;
+        }
+        return taskQueMaxBytes_ > 0 && !taskQue_.empty() && queueBytes_ + bytes > taskQueMaxBytes_;
+    }
+
+    // 从任务队列中移除最早的任务，由调用方在释放锁后以异常结束该任务，调用时需持有taskQueMtx_
+    TaskItem dropOldestTask() {
+        TaskItem item = std::move(taskQue_.front());
+        taskQue_.pop();
+        taskSize_--;
+        queueBytes_ -= item.bytes;
+
+        LOG_INFO() << "Task queue is full, dropped the oldest task";
+        statsCollector_.onDropped();
+        return item;
+    }
+
+    // 任务出队时以其排队时延更新准入控制的过载状态，调用时需持有taskQueMtx_
+    void onAdmissionDequeue(const TaskItem& item) {
+        if(admissionTarget_.count() == 0) {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if(taskQue_.empty()) {
+            // 队列已被取空，不存在积压
+            aboveTargetSince_ = {};
+            shedding_ = false;
+            return;
+        }
+        updateAdmission(now - item.enqueueTime, now);
+    }
+
+    // 根据排队时延更新过载状态，调用时需持有taskQueMtx_
+    // 排队时延自aboveTargetSince_起持续高于目标值超过interval时开始拒绝，低于目标值时立即停止
+    void updateAdmission(std::chrono::steady_clock::duration sojourn, std::chrono::steady_clock::time_point now) {
+        if(sojourn < admissionTarget_) {
+            aboveTargetSince_ = {};
+            shedding_ = false;
+        }
+        else if(aboveTargetSince_ == std::chrono::steady_clock::time_point{}) {
+            aboveTargetSince_ = now;
+        }
+        else if(!shedding_ && now - aboveTargetSince_ >= admissionInterval_) {
+            shedding_ = true;
+            LOG_WARN() << "Queue delay above admission target for "
+                       << std::chrono::duration_cast<std::chrono::milliseconds>(admissionInterval_).count()
+                       << "ms, shedding low priority tasks";
+        }
+    }
+
+    // 登记空闲线程的回收截止时间，调用时需持有taskQueMtx_
+    void addIdleDeadline(const IdleDeadline& deadline) {
+        auto it = idleDeadlines_.insert(deadline).first;
+
+        // 截止时间最早时才需要唤醒回收线程重新计算等待时间
+        if(it == idleDeadlines_.begin()) {
+            reaperCond_.notify_one();
+        }
+    }
+
+    // 撤销空闲线程的回收截止时间，回收线程已决定回收该线程时一并撤销，调用时需持有taskQueMtx_
+    void removeIdleDeadline(const IdleDeadline& deadline) {
+        if(idleDeadlines_.erase(deadline) == 0) {
+            reapedThreads_.erase(deadline.second);
+        }
+    }
+
+    // 回收线程，cached模式下按截止时间顺序回收空闲时间超过THREAD_MAX_IDLE_TIME的线程
+    /*
+        - 空闲线程只登记截止时间，无限期等待任务，不再周期性地醒来检查空闲时间
+        - 回收线程等待到最早的截止时间，将到期的线程加入reapedThreads_并唤醒空闲线程，
+          被回收的线程醒来后自行退出，线程数量不低于初始线程数量
+    */
+    void reaperFunc() {
+        Tracer::setThreadName("Reaper");
+
+        SiteLock lock(taskQueMtx_);
+        while(isPoolRunning_) {
+            auto now = std::chrono::steady_clock::now();
+            bool reaped = false;
+            while(
+                !idleDeadlines_.empty() &&
+                idleDeadlines_.begin()->first <= now &&                     // 已到截止时间
+                curThreadSize_ - reapedThreads_.size() > initThreadSize_    // 回收后线程数量不低于初始数量
+            ) {
+                reapedThreads_.insert(idleDeadlines_.begin()->second);
+                idleDeadlines_.erase(idleDeadlines_.begin());
+                reaped = true;
+            }
+
+            // 唤醒空闲线程，被回收的线程自行退出
+            if(reaped) {
+                taskQueNotEmpty_.notify_all();
+            }
+
+            if(idleDeadlines_.empty() || curThreadSize_ - reapedThreads_.size() <= initThreadSize_) {
+                // 无可回收的线程，等待新的截止时间登记或线程创建
+                reaperCond_.wait(lock);
+            }
+            else {
+                reaperCond_.wait_until(lock, idleDeadlines_.begin()->first);
+            }
+        }
+    }
+
+    // 占用一个空闲的轮询器，调用时需持有taskQueMtx_
+    IdlePoller* claimIdlePoller() {
+        for(auto& slot : idlePollers_) {
+            if(!slot.claimed && !slot.removing) {
+                slot.claimed = true;
+                pollingSize_++;
+                return slot.poller;
+            }
+        }
+        return nullptr;
+    }
+
+    // 释放占用的轮询器，调用时需持有taskQueMtx_
+    void releaseIdlePoller(IdlePoller* poller) {
+        for(auto& slot : idlePollers_) {
+            if(slot.poller == poller) {
+                slot.claimed = false;
+                pollingSize_--;
+                if(slot.removing) {
+                    pollerReleased_.notify_all();
+                }
+                return;
+            }
+        }
+    }
+
+    // 唤醒所有阻塞在轮询器上的线程，调用时需持有taskQueMtx_
+    void wakeupIdlePollers() {
+        for(auto& slot : idlePollers_) {
+            if(slot.claimed) {
+                slot.poller->wakeup();
+            }
+        }
+    }
+
+    // 判断线程池模式，模式由GrowthPolicy固定时在编译期求值
+    bool isMode(PoolMode mode) const {
+        if constexpr (GrowthPolicy::RUNTIME) {
+            return poolMode_ == mode;
+        }
+        else {
+            return GrowthPolicy::MODE == mode;
         }
     }
 
@@ -328,27 +1567,102 @@ private:
     std::atomic_uint curThreadSize_;                                // 当前线程池中线程的数量
     std::atomic_uint idleThreadSize_;                               // 当前线程池中空闲线程的数量
     
-    //// 任务
-    using Task = std::function<void()>;
-
     //// 任务队列
-    std::queue<Task> taskQue_;                                      // 任务队列
+    typename QueuePolicy::template Queue<TaskItem> taskQue_;        // 任务队列
     std::atomic_uint taskSize_;                                     // 任务数量
     size_t taskQueMaxThreshold_;                                    // 任务数量上限
+    std::atomic_size_t queueBytes_;                                 // 任务队列占用的内存
+    size_t taskQueMaxBytes_;                                        // 任务队列占用内存的上限，0表示不限制
 
     //// 互斥锁
-    std::mutex taskQueMtx_;                                         // 保证任务队列的线程安全
+    SiteMutex taskQueMtx_{"ThreadPool::taskQueMtx_"};               // 保证任务队列的线程安全
 
     //// 条件变量
-    std::condition_variable taskQueNotFull_;                        // 任务队列不满
-    std::condition_variable taskQueNotEmpty_;                       // 任务队列不空
-    std::condition_variable exitCond_;                              // 等待线程资源全部回收
+    SiteCondVar taskQueNotFull_;                                    // 任务队列不满
+    SiteCondVar taskQueNotEmpty_;                                   // 任务队列不空
+    SiteCondVar exitCond_;                                          // 等待线程资源全部回收
 
     //// 原子操作
     std::atomic_bool isPoolRunning_;                                // 当前线程池的运行状态
 
     //// 线程池工作模式
     PoolMode poolMode_;                                             // 当前线程池工作模式
+
+    //// 性能计数器
+    bool perfCounterEnabled_;                                       // 是否开启性能计数器统计
+    std::mutex perfMtx_;                                            // 保证计数记录容器的线程安全
+    std::vector<std::shared_ptr<PerfRecord>> perfRecords_;          // 各工作线程的计数记录
+    std::shared_ptr<PerfRecord> exitedPerfRecord_;                  // 已回收线程合并后的计数记录，首次合并时创建
+
+    //// 运行时统计
+    StatsPolicy statsCollector_;                                    // 分片的计数器与直方图
+
+    //// 看门狗
+    std::chrono::milliseconds watchdogThreshold_;                   // 任务执行时间上限，0表示不开启
+    bool watchdogCompensate_;                                       // fixed模式下是否补偿临时线程
+    std::atomic_int flaggedRunning_;                                // 仍在运行的被标记任务数量
+    std::atomic_int compensateThreadSize_;                          // 当前补偿线程的数量
+    std::thread watchdogThread_;                                    // 看门狗线程
+    std::mutex watchdogMtx_;                                        // 看门狗线程的等待锁
+    std::condition_variable watchdogCond_;                          // 唤醒看门狗线程退出
+
+    //// 空闲轮询器
+    struct IdlePollerSlot
+    {
+        IdlePoller* poller;                                         // 轮询器
+        bool claimed;                                               // 是否有工作线程阻塞在其上
+        bool removing = false;                                      // 是否正在注销
+    };
+    std::vector<IdlePollerSlot> idlePollers_;                       // 已注册的轮询器
+    size_t pollingSize_;                                            // 阻塞在轮询器上的线程数量
+    SiteCondVar pollerReleased_;                                    // 正在注销的轮询器被释放
+
+    //// 空闲线程回收（cached模式）
+    std::set<IdleDeadline> idleDeadlines_;                          // 空闲线程的回收截止时间与线程id，按截止时间排序
+    std::unordered_set<size_t> reapedThreads_;                      // 回收线程已决定回收、尚未退出的线程
+    SiteCondVar reaperCond_;                                        // 唤醒回收线程
+    std::thread reaperThread_;                                      // 回收线程
+
+    //// 溢出策略
+    OverflowPolicy overflowPolicy_;                                 // 任务队列已满时的溢出策略
+    std::chrono::milliseconds overflowTimeout_;                     // POLICY_TIMEOUT的等待时间
+
+    //// 准入控制
+    std::chrono::microseconds admissionTarget_;                     // 目标排队时延，0表示不开启
+    std::chrono::microseconds admissionInterval_;                   // 排队时延持续高于目标值多久后开始拒绝
+    std::chrono::steady_clock::time_point aboveTargetSince_;        // 排队时延开始高于目标值的时间，空表示未高于
+    std::atomic_bool shedding_;                                     // 是否正在拒绝低优先级任务
+
+    //// 运行时调整线程数量（fixed模式）
+    size_t retiringSize_;                                           // 需要退出、尚未退出的常驻线程数量
+    std::string threadNamePrefix_;                                  // 线程名称前缀
+    size_t nextThreadIndex_;                                        // 新线程名称的编号
+    bool cpuLimitWatch_;                                            // 是否跟随CPU配额调整线程数量
+    std::thread cpuLimitThread_;                                    // CPU配额跟随线程
+    std::mutex cpuLimitMtx_;                                        // CPU配额跟随线程的等待锁
+    std::condition_variable cpuLimitCond_;                          // 唤醒CPU配额跟随线程退出
+
+    //// 线程属性
+    ThreadAttr threadAttr_;                                         // 工作线程的栈大小与保护区大小
+    bool releaseIdleStack_;                                         // 是否在线程长时间空闲前释放栈内存
+
+    //// 异步文件I/O，所有工作线程退出后才析构
+    FileIoMode fileIoMode_;                                         // 异步文件I/O的实现方式
+    std::once_flag fileIoOnce_;                                     // 保证只创建一次
+    std::unique_ptr<AsyncFileIO> fileIO_;                           // 异步文件I/O
+
+    //// 工作线程局部存储
+    std::atomic_size_t workerContexts_;                             // 尚未析构的工作线程上下文数量
+
+    //// 线程局部变量
+    static inline thread_local const BasicThreadPool* currentPool_ = nullptr;  // 当前线程所属的线程池
+    static inline thread_local typename StatsPolicy::WorkerRecord* currentWorkerStats_ = nullptr;  // 当前线程的统计记录
+    static inline thread_local PerfProbe* currentPerfProbe_ = nullptr;                          // 当前线程的性能计数器探针
+    static inline thread_local WorkerContext* currentContext_ = nullptr;                        // 当前工作线程的上下文
+    static inline thread_local ForeignScope* foreignScope_ = nullptr;                           // 非工作线程最内层的任务上下文作用域
 };
 
+// 默认策略的线程池：运行时选择fixed/cached模式，开启统计
+using ThreadPool = BasicThreadPool<>;
+
 #endif
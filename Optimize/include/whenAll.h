@@ -0,0 +1,178 @@
+#ifndef __WHENALL_H__
+#define __WHENALL_H__
+
+#include <vector>
+#include <tuple>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <cstddef>
+
+#include "taskFuture.h"
+
+// when_any的结果：首个完成的future的下标与全部future
+template<typename Sequence>
+struct WhenAnyResult
+{
+    size_t index;           // 首个完成的future的下标，输入为空时为static_cast<size_t>(-1)
+    Sequence futures;       // 全部输入的future
+};
+
+// 组合线程池任务的future
+/*
+    - 通过TaskFuture的完成通知实现：每个输入任务结束时，由执行该任务的工作线程对原子计数减1，
+      最后一个（when_any为第一个）结束的任务写入结果，每个完成的任务只有O(1)的开销，
+      聚合过程不需要任何线程阻塞在get()上
+    - 返回的TaskFuture同样可以注册完成回调或继续组合，作为continuation使用：
+          when_all(first, last).onComplete([]() { ... });
+    - 每个输入future的完成回调会被占用，不能再用于其它组合或onComplete()
+    - 输入的future被移动到结果中，完成后通过结果逐个get()
+*/
+namespace detail {
+
+// 组合结果的共享状态
+template<typename Sequence>
+struct WhenState
+{
+    explicit WhenState(size_t count)
+        : remaining(count)
+        , completion(std::make_shared<TaskCompletion>())
+    {}
+
+    std::atomic<size_t> remaining;                  // 尚未结束的输入数量
+    Sequence futures;                               // 输入的future
+    std::promise<Sequence> allPromise;              // when_all的结果
+    std::promise<WhenAnyResult<Sequence>> anyPromise;   // when_any的结果
+    std::shared_ptr<TaskCompletion> completion;     // 组合结果的完成通知
+};
+
+// 对输入的完成通知注册回调，没有完成通知的future视为已结束
+inline void onInputComplete(const std::shared_ptr<TaskCompletion>& completion, std::function<void()> callback) {
+    if(completion) {
+        completion->then(std::move(callback));
+    }
+    else {
+        callback();
+    }
+}
+
+} // namespace detail
+
+// 等待区间内的全部future结束，返回持有全部输入future的TaskFuture
+template<typename Iterator>
+auto when_all(Iterator first, Iterator last)
+    -> TaskFuture<std::vector<typename std::iterator_traits<Iterator>::value_type>> {
+    using Sequence = std::vector<typename std::iterator_traits<Iterator>::value_type>;
+    using State = detail::WhenState<Sequence>;
+
+    auto state = std::make_shared<State>(0);
+    state->futures.reserve(std::distance(first, last));
+    for(; first != last; ++first) {
+        state->futures.emplace_back(std::move(*first));
+    }
+    TaskFuture<Sequence> result(state->allPromise.get_future(), state->completion);
+
+    // 先取出完成通知，回调可能在注册过程中执行并移走futures
+    std::vector<std::shared_ptr<TaskCompletion>> completions;
+    completions.reserve(state->futures.size());
+    for(auto& future : state->futures) {
+        completions.emplace_back(future.completion());
+    }
+
+    // 计数多加1，保证注册完成之前结果不会被写入
+    state->remaining = completions.size() + 1;
+    auto arrive = [state]() {
+        if(--state->remaining == 0) {
+            state->allPromise.set_value(std::move(state->futures));
+            state->completion->fire();
+        }
+    };
+    for(auto& completion : completions) {
+        detail::onInputComplete(completion, arrive);
+    }
+    arrive();
+
+    return result;
+}
+
+// 等待全部future结束，返回持有全部输入future的TaskFuture<std::tuple<...>>
+template<typename... Ts>
+auto when_all(TaskFuture<Ts>... futures) -> TaskFuture<std::tuple<TaskFuture<Ts>...>> {
+    using Sequence = std::tuple<TaskFuture<Ts>...>;
+    using State = detail::WhenState<Sequence>;
+
+    std::shared_ptr<TaskCompletion> completions[] = { futures.completion()..., nullptr };
+
+    auto state = std::make_shared<State>(sizeof...(Ts) + 1);
+    state->futures = Sequence(std::move(futures)...);
+    TaskFuture<Sequence> result(state->allPromise.get_future(), state->completion);
+
+    auto arrive = [state]() {
+        if(--state->remaining == 0) {
+            state->allPromise.set_value(std::move(state->futures));
+            state->completion->fire();
+        }
+    };
+    for(size_t i = 0; i < sizeof...(Ts); ++i) {
+        detail::onInputComplete(completions[i], arrive);
+    }
+    arrive();
+
+    return result;
+}
+
+// 等待区间内任一future结束，返回首个结束的下标与全部输入future
+template<typename Iterator>
+auto when_any(Iterator first, Iterator last)
+    -> TaskFuture<WhenAnyResult<std::vector<typename std::iterator_traits<Iterator>::value_type>>> {
+    using Sequence = std::vector<typename std::iterator_traits<Iterator>::value_type>;
+    using State = detail::WhenState<Sequence>;
+
+    auto state = std::make_shared<State>(0);
+    state->futures.reserve(std::distance(first, last));
+    for(; first != last; ++first) {
+        state->futures.emplace_back(std::move(*first));
+    }
+    TaskFuture<WhenAnyResult<Sequence>> result(state->anyPromise.get_future(), state->completion);
+
+    std::vector<std::shared_ptr<TaskCompletion>> completions;
+    completions.reserve(state->futures.size());
+    for(auto& future : state->futures) {
+        completions.emplace_back(future.completion());
+    }
+
+    // remaining作为门闩：首个结束的输入与注册线程各减1，后减为0的一方写入结果，
+    // 保证注册过程中不会写入结果；输入为空时只由注册线程减1
+    state->remaining = completions.empty() ? 1 : 2;
+    auto firstIndex = std::make_shared<std::atomic<size_t>>(static_cast<size_t>(-1));
+    auto finish = [state, firstIndex]() {
+        state->anyPromise.set_value(WhenAnyResult<Sequence>{ firstIndex->load(), std::move(state->futures) });
+        state->completion->fire();
+    };
+
+    for(size_t i = 0; i < completions.size(); ++i) {
+        detail::onInputComplete(completions[i], [state, firstIndex, finish, i]() {
+            size_t expected = static_cast<size_t>(-1);
+            if(firstIndex->compare_exchange_strong(expected, i) && --state->remaining == 0) {
+                finish();
+            }
+        });
+
+        // 已有输入结束时不必继续注册
+        if(firstIndex->load() != static_cast<size_t>(-1)) {
+            break;
+        }
+    }
+
+    // 注册结束
+    if(--state->remaining == 0) {
+        finish();
+    }
+
+    return result;
+}
+
+#endif
@@ -15,6 +15,8 @@ int main()
     ThreadPool pool;
     // 设置为CACHED模式
     pool.setMode(PoolMode::MODE_CACHED);
+    // 开启工作线程性能计数器
+    pool.setPerfCounterEnabled(true);
     // 设置线程池中初始线程个数为3
     pool.start(3);
 
@@ -32,5 +34,25 @@ int main()
     std::cout << r3.get() << "\n";
     std::cout << r4.get() << "\n";
 
+    // 输出各工作线程执行任务期间的性能计数，不可用的事件输出n/a
+    for(auto& snap : pool.getPerfSnapshot()) {
+        std::cout << snap.threadName << ": tasks=" << snap.taskCount;
+        for(int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            std::cout << " " << perfEventName(i) << "=";
+            if(snap.available[i]) {
+                std::cout << snap.taskCounts[i];
+            }
+            else {
+                std::cout << "n/a";
+            }
+        }
+        std::cout << "\n";
+    }
+
+#if LOCK_PROFILE_ENABLED
+    // 输出各加锁位置的竞争统计
+    std::cout << LockProfiler::report();
+#endif
+
     return 0;
 }
\ No newline at end of file
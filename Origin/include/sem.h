@@ -5,6 +5,8 @@
 #include <mutex>
 #include <atomic>
 
+#include "lockProfiler.h"
+
 // 自定义信号量 -- 互斥锁 + 条件变量
 class Semaphore
 {
@@ -24,8 +26,8 @@ public:
 private:
     std::atomic_bool isExit_;
     size_t resourceCount_;          // 资源计数
-    std::mutex mtx_;                // 互斥锁
-    std::condition_variable cond_;  // 条件变量
+    SiteMutex mtx_;                 // 互斥锁
+    SiteCondVar cond_;              // 条件变量
 };
 
 #endif
\ No newline at end of file
@@ -51,6 +51,13 @@ public:
     void start(size_t initThreadSize = std::thread::hardware_concurrency());
 
 private:
+    // 任务队列中的元素
+    struct TaskItem
+    {
+        std::shared_ptr<Task> task;     // 任务
+        uint64_t traceId;               // 追踪id，提交时分配，0表示未追踪
+    };
+
     // 定义线程执行函数（消费者，不断从任务队列中获取任务）
     void threadFunc(size_t threadId);
 
@@ -83,7 +90,7 @@ private:
             - 使用智能指针
     */ 
     //// 任务队列
-    std::queue<std::shared_ptr<Task>> taskQue_;    // 任务队列
+    std::queue<TaskItem> taskQue_;                 // 任务队列
     std::atomic_uint taskSize_;                    // 任务数量
     size_t taskQueMaxThreshold_;                   // 任务数量上限
 
@@ -4,6 +4,7 @@
 Semaphore::Semaphore(size_t count)
     : resourceCount_(count)
     , isExit_(false)
+    , mtx_("Semaphore::mtx_")
 {}
 
 // 析构函数
@@ -18,7 +19,7 @@ void Semaphore::wait() {
     }
 
     // 获取互斥锁
-    std::unique_lock<std::mutex> lock(mtx_);
+    SiteLock lock(mtx_);
 
     cond_.wait(lock, [&]()->bool{
         return resourceCount_ > 0;
@@ -35,7 +36,7 @@ void Semaphore::post() {
     }
 
     // 获取互斥锁
-    std::unique_lock<std::mutex> lock(mtx_);
+    SiteLock lock(mtx_);
 
     // 资源计数+1
     resourceCount_++;
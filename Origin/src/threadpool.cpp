@@ -1,4 +1,5 @@
 #include "threadpool.h"
+#include "tracer.h"
 
 const int TASK_MAX_THRESHOLD   = INT32_MAX;
 const int THREAD_MAX_THRESHOLD = 1024;
@@ -86,8 +87,15 @@ Result ThreadPool::submitTask(std::shared_ptr<Task> task) {
         return Result(task, false);
     }
 
+    // 每次提交分配新的追踪id，同一任务对象重复提交或地址被复用时不会串连无关的flow
+    uint64_t traceId = 0;
+    if(Tracer::isEnabled()) {
+        traceId = Tracer::nextId();
+        Tracer::flowBegin("submit", "task", traceId);
+    }
+
     // 若队列未满，则向任务队列中添加任务
-    taskQue_.emplace(task);
+    taskQue_.emplace(TaskItem{ task, traceId });
 
     // 任务数量+1
     taskSize_++;
@@ -113,6 +121,10 @@ Result ThreadPool::submitTask(std::shared_ptr<Task> task) {
         curThreadSize_++;
         idleThreadSize_++;
 
+        if(Tracer::isEnabled()) {
+            Tracer::instant("spawn", "thread");
+        }
+
         // std::cout << "Create New Thread!\n";
     }
 
@@ -141,10 +153,11 @@ void ThreadPool::start(size_t initThreadSize) {
     }
 
     // 启动所有线程
-    for(size_t i = 0; i < initThreadSize_; ++i) {
-        threads_[i]->start();
-
+    // 线程id全局递增，同一进程中创建多个线程池时不从0开始，因此遍历线程容器而不是按下标访问
+    for(auto& item : threads_) {
         idleThreadSize_++;          // 记录空闲线程的数量
+
+        item.second->start();
     }
 
     // std::cout << "Create " << initThreadSize << " Init Thread\n";
@@ -152,6 +165,9 @@ void ThreadPool::start(size_t initThreadSize) {
 
 // 线程执行函数，消费者：从任务队列中取出任务执行
 void ThreadPool::threadFunc(size_t threadId) {
+    // 设置追踪视图中的线程名称
+    Tracer::setThreadName("OriginThread-" + std::to_string(threadId));
+
     // 记录当前时间
     auto lastTime = std::chrono::high_resolution_clock().now();
 
@@ -159,6 +175,7 @@ void ThreadPool::threadFunc(size_t threadId) {
     // 等待所有任务执行完成后，才可以回收线程池资源
     for(;;) {
         std::shared_ptr<Task> task;
+        uint64_t traceId = 0;
         {
             // 获取锁
             /*
@@ -203,6 +220,10 @@ void ThreadPool::threadFunc(size_t threadId) {
                             curThreadSize_--;
                             idleThreadSize_--;
 
+                            if(Tracer::isEnabled()) {
+                                Tracer::instant("reap", "thread");
+                            }
+
                             // std::cout << "threadid: " << std::this_thread::get_id() << " exit!\n";
                             
                             // 持有锁时return，即线程持有互斥锁时直接退出的情况
@@ -223,7 +244,8 @@ void ThreadPool::threadFunc(size_t threadId) {
             // std::cout << "Tid: " << std::this_thread::get_id() << " Get Task Success!\n";
 
             // 从任务队列的队头取出任务
-            task = taskQue_.front();
+            task = taskQue_.front().task;
+            traceId = taskQue_.front().traceId;
             // 出队
             taskQue_.pop();
 
@@ -246,7 +268,19 @@ void ThreadPool::threadFunc(size_t threadId) {
             否则会导致当前线程在任务执行完后才会把互斥锁释放
         */
         if(task != nullptr) {  
-            task->exec();   // 执行任务；将任务的返回值通过setVal()方法给到Result
+            // 追踪id仅在提交时开启了追踪才不为0
+            if(traceId != 0) {
+                uint64_t traceBegin = Tracer::now();
+                Tracer::instant("dequeue", "task", traceId);
+                Tracer::flowEnd("submit", "task", traceId, traceBegin);
+
+                task->exec();
+
+                Tracer::complete("execute", "task", traceBegin, Tracer::now(), traceId);
+            }
+            else {
+                task->exec();   // 执行任务；将任务的返回值通过setVal()方法给到Result
+            }
         }
 
         // 线程任务完成，线程空闲数量加1
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <unistd.h>
+
+#include "threadpoolOpt.h"
+#include "pool_algorithms.h"
+
+// 计时工具
+template<typename Func>
+double timeMs(Func&& func) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// 输出一行对比结果
+void report(const std::string& name, size_t n, double serialMs, double parallelMs, bool ok) {
+    std::cout << name << " n=" << n
+              << " std: " << serialMs << " ms"
+              << " pool: " << parallelMs << " ms"
+              << " speedup: " << serialMs / parallelMs
+              << (ok ? "" : " MISMATCH") << "\n";
+}
+
+// 单个规模下的全部对比
+void runAll(ThreadPool& pool, size_t n) {
+    std::vector<int32_t> data(n);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int32_t> dist(-1000, 1000);
+    for(auto& v : data) {
+        v = dist(gen);
+    }
+
+    std::vector<int32_t> out1(n);
+    std::vector<int32_t> out2(n);
+    double s = 0;
+    double p = 0;
+
+    //// transform
+    auto square = [](int32_t v) { return v * v; };
+    s = timeMs([&]() { std::transform(data.begin(), data.end(), out1.begin(), square); });
+    p = timeMs([&]() { parallel::transform(pool, data.begin(), data.end(), out2.begin(), square); });
+    report("transform", n, s, p, out1 == out2);
+
+    //// inclusive_scan
+    s = timeMs([&]() { std::inclusive_scan(data.begin(), data.end(), out1.begin()); });
+    p = timeMs([&]() { parallel::inclusive_scan(pool, data.begin(), data.end(), out2.begin()); });
+    report("inclusive_scan", n, s, p, out1 == out2);
+
+    //// exclusive_scan
+    s = timeMs([&]() { std::exclusive_scan(data.begin(), data.end(), out1.begin(), 0); });
+    p = timeMs([&]() { parallel::exclusive_scan(pool, data.begin(), data.end(), out2.begin(), 0); });
+    report("exclusive_scan", n, s, p, out1 == out2);
+
+    //// count_if
+    size_t c1 = 0;
+    size_t c2 = 0;
+    auto positive = [](int32_t v) { return v > 0; };
+    s = timeMs([&]() { c1 = std::count_if(data.begin(), data.end(), positive); });
+    p = timeMs([&]() { c2 = parallel::count_if(pool, data.begin(), data.end(), positive); });
+    report("count_if", n, s, p, c1 == c2);
+
+    //// min_element / max_element
+    auto it1 = data.begin();
+    auto it2 = data.begin();
+    s = timeMs([&]() { it1 = std::min_element(data.begin(), data.end()); });
+    p = timeMs([&]() { it2 = parallel::min_element(pool, data.begin(), data.end()); });
+    report("min_element", n, s, p, it1 == it2);
+
+    s = timeMs([&]() { it1 = std::max_element(data.begin(), data.end()); });
+    p = timeMs([&]() { it2 = parallel::max_element(pool, data.begin(), data.end()); });
+    report("max_element", n, s, p, it1 == it2);
+
+    //// sort
+    out1 = data;
+    out2 = data;
+    s = timeMs([&]() { std::sort(out1.begin(), out1.end()); });
+    p = timeMs([&]() { parallel::sort(pool, out2.begin(), out2.end()); });
+    report("sort", n, s, p, out1 == out2);
+}
+
+int main(int argc, char* argv[])
+{
+    // 默认规模：1M、100M、1B，可通过命令行参数指定
+    std::vector<size_t> sizes = { 1000000, 100000000, 1000000000 };
+    if(argc > 1) {
+        sizes.clear();
+        for(int i = 1; i < argc; ++i) {
+            sizes.push_back(std::stoull(argv[i]));
+        }
+    }
+
+    ThreadPool pool;
+    pool.setMode(PoolMode::MODE_FIXED);
+    pool.start();
+
+    std::cout << "threads: " << pool.getThreadSize() << " (+ calling thread)\n";
+
+    // 输入、两个输出数组以及排序的临时空间
+    size_t physBytes = static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGE_SIZE);
+    for(size_t n : sizes) {
+        if(n * sizeof(int32_t) * 4 > physBytes) {
+            std::cout << "skip n=" << n << ": needs " << (n * sizeof(int32_t) * 4 >> 20)
+                      << " MB, physical memory " << (physBytes >> 20) << " MB\n";
+            continue;
+        }
+        runAll(pool, n);
+    }
+
+    return 0;
+}
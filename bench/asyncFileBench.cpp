@@ -0,0 +1,113 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <future>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "threadpoolOpt.h"
+
+// 计时工具
+template<typename Func>
+double timeMs(Func&& func) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// 输出一行结果
+void report(const char* name, double ms, size_t files, size_t fileSize, size_t bytes) {
+    std::cout << name << ": " << ms << " ms, " << files / ms * 1e3 << " files/s, "
+              << bytes / ms / 1e3 << " MB/s" << (bytes == files * fileSize ? "" : " (SHORT READ)") << "\n";
+}
+
+// 通过线程池异步读取所有文件
+size_t readAsync(ThreadPool& pool, const std::vector<int>& fds, std::vector<std::vector<char>>& buffers) {
+    std::vector<TaskFuture<ssize_t>> results;
+    results.reserve(fds.size());
+    for(size_t i = 0; i < fds.size(); ++i) {
+        results.emplace_back(pool.asyncRead(fds[i], buffers[i].data(), buffers[i].size(), 0));
+    }
+
+    size_t bytes = 0;
+    for(auto& result : results) {
+        bytes += result.get();
+    }
+    return bytes;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t files = argc > 1 ? std::stoul(argv[1]) : 2000;
+    size_t fileSize = argc > 2 ? std::stoul(argv[2]) : 64 * 1024;
+    size_t threads = 4;
+
+    // 优先使用tmpfs
+    std::string dir = access("/dev/shm", W_OK) == 0 ? "/dev/shm" : "/tmp";
+    dir += "/asyncFileBench." + std::to_string(getpid());
+    mkdir(dir.c_str(), 0700);
+
+    std::vector<char> content(fileSize, 'x');
+    std::vector<std::string> paths;
+    std::vector<int> fds;
+    for(size_t i = 0; i < files; ++i) {
+        paths.emplace_back(dir + "/" + std::to_string(i));
+        int fd = open(paths.back().c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+        ssize_t ret = write(fd, content.data(), content.size());
+        (void)ret;
+        fds.push_back(fd);
+    }
+    std::vector<std::vector<char>> buffers(files, std::vector<char>(fileSize));
+
+    std::cout << "reading " << files << " files x " << fileSize / 1024 << " KB from " << dir << "\n";
+
+    // 工作线程中阻塞pread
+    {
+        ThreadPool pool;
+        pool.start(threads);
+        size_t bytes = 0;
+        double ms = timeMs([&]() {
+            std::vector<TaskFuture<ssize_t>> results;
+            for(size_t i = 0; i < files; ++i) {
+                results.emplace_back(pool.submitTask([&, i]() {
+                    return pread(fds[i], buffers[i].data(), buffers[i].size(), 0);
+                }));
+            }
+            for(auto& result : results) {
+                bytes += result.get();
+            }
+        });
+        report("submitTask + pread", ms, files, fileSize, bytes);
+    }
+
+    // io_uring
+    {
+        ThreadPool pool;
+        pool.start(threads);
+        size_t bytes = 0;
+        double ms = timeMs([&]() { bytes = readAsync(pool, fds, buffers); });
+        report("asyncRead (auto)", ms, files, fileSize, bytes);
+    }
+
+    // 阻塞I/O线程组
+    {
+        ThreadPool pool;
+        pool.setFileIoMode(FileIoMode::MODE_BLOCKING);
+        pool.start(threads);
+        size_t bytes = 0;
+        double ms = timeMs([&]() { bytes = readAsync(pool, fds, buffers); });
+        report("asyncRead (blocking threads)", ms, files, fileSize, bytes);
+    }
+
+    for(size_t i = 0; i < files; ++i) {
+        close(fds[i]);
+        unlink(paths[i].c_str());
+    }
+    rmdir(dir.c_str());
+
+    return 0;
+}
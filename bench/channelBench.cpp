@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <optional>
+
+#include "threadpoolOpt.h"
+#include "channel.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 仿照任务队列taskQue_的有界队列：std::queue + 互斥锁 + 条件变量，空/满时工作线程阻塞
+template<typename T>
+class MutexQueue
+{
+public:
+    explicit MutexQueue(size_t capacity)
+        : capacity_(capacity)
+    {}
+
+    void send(T value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        notFull_.wait(lock, [&]()->bool{ return que_.size() < capacity_; });
+        que_.emplace(std::move(value));
+        notEmpty_.notify_one();
+    }
+
+    std::optional<T> recv() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        notEmpty_.wait(lock, [&]()->bool{ return !que_.empty(); });
+        T value = std::move(que_.front());
+        que_.pop();
+        notFull_.notify_one();
+        return value;
+    }
+
+private:
+    size_t capacity_;
+    std::queue<T> que_;
+    std::mutex mtx_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+};
+
+// producers个生产者任务经同一个队列向调用线程发送items个数据，返回Mitems/s
+template<typename Queue>
+double run(ThreadPool& pool, Queue& queue, size_t producers, size_t items) {
+    std::vector<std::future<void>> results;
+    size_t perProducer = items / producers;
+
+    auto begin = Clock::now();
+    for(size_t i = 0; i < producers; ++i) {
+        results.emplace_back(pool.submitTask([&queue, perProducer]() {
+            for(size_t j = 0; j < perProducer; ++j) {
+                queue.send(j);
+            }
+        }));
+    }
+
+    size_t sum = 0;
+    for(size_t i = 0; i < perProducer * producers; ++i) {
+        sum += *queue.recv();
+    }
+    for(auto& result : results) {
+        result.get();
+    }
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+
+    if(sum != producers * perProducer * (perProducer - 1) / 2) {
+        std::cerr << "checksum mismatch\n";
+    }
+    return perProducer * producers / us;
+}
+
+// 生产者任务多于工作线程时，互斥锁队列的满队列阻塞占住工作线程，Channel在满时协助执行其它生产者任务
+int main(int argc, char* argv[])
+{
+    size_t items = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    size_t capacity = argc > 2 ? std::stoul(argv[2]) : 256;
+    size_t threads = 4;
+
+    ThreadPool pool;
+    pool.setMode(PoolMode::MODE_FIXED);
+    pool.start(threads);
+
+    std::cout << std::left << std::setw(12) << "producers"
+              << std::right << std::setw(22) << "mutex queue" << std::setw(22) << "Channel" << "\n";
+
+    for(size_t producers : {1, 4, 16}) {
+        MutexQueue<size_t> mutexQueue(capacity);
+        Channel<size_t> channel(pool, capacity);
+
+        double mutexRate = run(pool, mutexQueue, producers, items);
+        double channelRate = run(pool, channel, producers, items);
+        std::cout << std::left << std::setw(12) << producers
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(2) << mutexRate << " Mitems/s"
+                  << std::setw(12) << channelRate << " Mitems/s\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "threadpoolOpt.h"
+#include "coalescer.h"
+
+// 微小任务：约几十ns的计算
+inline void tinyWork(std::atomic<uint64_t>& counter, uint64_t seed) {
+    uint64_t x = seed;
+    for(int i = 0; i < 16; ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    counter.fetch_add(x & 1, std::memory_order_relaxed);
+}
+
+// 计时工具
+template<typename Func>
+double timeMs(Func&& func) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// 输出一行结果
+void report(const char* name, size_t tasks, double ms, size_t batchSize) {
+    std::cout << name << ": " << ms << " ms, " << tasks / ms / 1e3 << " Mtasks/s";
+    if(batchSize > 0) {
+        std::cout << ", batch size " << batchSize;
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+    size_t tasks = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    ThreadPool pool;
+    pool.setMode(PoolMode::MODE_FIXED);
+    pool.start(4);
+
+    std::atomic<uint64_t> counter(0);
+
+    // 逐个提交
+    double ms = timeMs([&]() {
+        std::vector<std::future<void>> results;
+        results.reserve(tasks);
+        for(size_t i = 0; i < tasks; ++i) {
+            results.emplace_back(pool.submitTask(tinyWork, std::ref(counter), i));
+        }
+        for(auto& result : results) {
+            result.get();
+        }
+    });
+    report("submitTask", tasks, ms, 0);
+
+    // 固定批量大小
+    for(size_t batchSize : { 16, 256 }) {
+        CoalesceOptions options;
+        options.initBatchSize = batchSize;
+        options.adaptive = false;
+
+        TaskCoalescer coalescer(pool, options);
+        ms = timeMs([&]() {
+            for(size_t i = 0; i < tasks; ++i) {
+                coalescer.post([&counter, i]() { tinyWork(counter, i); });
+            }
+            coalescer.wait();
+        });
+        report("coalesce fixed", tasks, ms, coalescer.getBatchSize());
+    }
+
+    // 自适应批量大小
+    TaskCoalescer coalescer(pool);
+    ms = timeMs([&]() {
+        for(size_t i = 0; i < tasks; ++i) {
+            coalescer.post([&counter, i]() { tinyWork(counter, i); });
+        }
+        coalescer.wait();
+    });
+    report("coalesce adaptive", tasks, ms, coalescer.getBatchSize());
+
+    return 0;
+}
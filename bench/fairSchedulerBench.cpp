@@ -0,0 +1,88 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <string>
+
+#include "threadpoolOpt.h"
+#include "fairScheduler.h"
+#include "histogram.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 忙等约us微秒，模拟计算任务
+void spin(int us) {
+    auto end = Clock::now() + std::chrono::microseconds(us);
+    while(Clock::now() < end) {}
+}
+
+// 输出一个租户的等待时间分位数
+void report(const char* mode, const std::string& tenant, const HistogramSnapshot& wait) {
+    std::cout << mode << "\t" << tenant
+              << "\ttasks " << wait.count
+              << "\tp50 " << wait.percentile(0.5) / 1e3 << " us"
+              << "\tp99 " << wait.percentile(0.99) / 1e3 << " us\n";
+}
+
+// 按记录值构造直方图快照
+HistogramSnapshot snapshot(const LogHistogram& histogram) {
+    HistogramSnapshot snapshot;
+    histogram.addTo(snapshot.buckets, snapshot.sum);
+    for(uint64_t v : snapshot.buckets) {
+        snapshot.count += v;
+    }
+    return snapshot;
+}
+
+// 两个租户共享线程池：noisy租户提交的任务数量是quiet租户的100倍
+int main(int argc, char* argv[])
+{
+    size_t quietTasks = argc > 1 ? std::stoul(argv[1]) : 200;
+    const size_t RATIO = 100;
+    const int TASK_US = 20;
+    const size_t THREADS = 4;
+
+    // 直接提交到线程池：quiet租户的任务排在noisy租户的积压之后
+    {
+        ThreadPool pool;
+        pool.start(THREADS);
+
+        LogHistogram noisyWait, quietWait;
+        std::vector<std::future<void>> results;
+        for(size_t i = 0; i < quietTasks * RATIO; ++i) {
+            bool quiet = i % RATIO == 0;
+            LogHistogram& wait = quiet ? quietWait : noisyWait;
+            auto submitTime = Clock::now();
+            results.emplace_back(pool.submitTask([&wait, submitTime]() {
+                wait.record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - submitTime).count());
+                spin(TASK_US);
+            }));
+        }
+        for(auto& result : results) {
+            result.get();
+        }
+
+        report("submitTask", "noisy", snapshot(noisyWait));
+        report("submitTask", "quiet", snapshot(quietWait));
+    }
+
+    // 多租户公平调度：quiet租户的任务与noisy租户轮流执行
+    {
+        ThreadPool pool;
+        pool.start(THREADS);
+
+        FairScheduler scheduler(pool, THREADS);
+        auto noisy = scheduler.addTenant("noisy");
+        auto quiet = scheduler.addTenant("quiet");
+
+        for(size_t i = 0; i < quietTasks * RATIO; ++i) {
+            scheduler.submit(i % RATIO == 0 ? quiet : noisy, spin, TASK_US);
+        }
+        scheduler.wait();
+
+        for(auto& stats : scheduler.stats()) {
+            report("FairScheduler", stats.name, stats.waitTime);
+        }
+    }
+
+    return 0;
+}
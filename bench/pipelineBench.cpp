@@ -0,0 +1,112 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <optional>
+
+#include "threadpoolOpt.h"
+#include "pipeline.h"
+
+// 模拟 解析 -> 转换 -> 压缩 -> 写入 的数据处理链路
+const size_t ITEM_COUNT = 20000;
+const size_t ITEM_BYTES = 16 * 1024;
+
+std::atomic_long liveBytes(0);      // 当前在途数据占用的内存
+std::atomic_long peakBytes(0);      // 在途数据内存峰值
+
+// 数据块，统计在途内存
+struct Block
+{
+    explicit Block(size_t bytes) : data(bytes, 'x') { track(data.size()); }
+    Block(Block&& other) noexcept : data(std::move(other.data)) {}
+    ~Block() { track(-static_cast<long>(data.size())); }
+
+    static void track(long delta) {
+        long now = liveBytes += delta;
+        long peak = peakBytes;
+        while(now > peak && !peakBytes.compare_exchange_weak(peak, now)) {}
+    }
+
+    std::string data;
+};
+
+// 各个阶段的处理函数
+Block parse(size_t i) { return Block(ITEM_BYTES + i % 7); }
+Block transform(Block b) { for(size_t i = 0; i < b.data.size(); i += 64) b.data[i] ^= 1; return b; }
+Block compress(Block b) { return b; }
+void write(Block b, size_t& written) {
+    // 模拟较慢的写入阶段
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+    written += b.data.size();
+}
+
+int main()
+{
+    ThreadPool pool;
+    pool.setMode(PoolMode::MODE_FIXED);
+    pool.start(4);
+
+    //// 任务内部链式调用submitTask：写入阶段慢于解析阶段时，中间结果不断堆积
+    {
+        peakBytes = 0;
+        std::mutex writeMtx;
+        size_t written = 0;
+        auto begin = std::chrono::steady_clock::now();
+
+        // 每个阶段完成后向线程池提交下一个阶段，中间结果在任务队列中等待
+        std::atomic_size_t done(0);
+        for(size_t i = 0; i < ITEM_COUNT; ++i) {
+            pool.submitTask([&, i]() {
+                auto parsed = std::make_shared<Block>(parse(i));
+                pool.submitTask([&, parsed]() {
+                    auto transformed = std::make_shared<Block>(transform(std::move(*parsed)));
+                    pool.submitTask([&, transformed]() {
+                        auto compressed = std::make_shared<Block>(compress(std::move(*transformed)));
+                        pool.submitTask([&, compressed]() {
+                            std::lock_guard<std::mutex> lock(writeMtx);
+                            write(std::move(*compressed), written);
+                            done++;
+                        });
+                    });
+                });
+            });
+        }
+        while(done < ITEM_COUNT) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "chained submitTask: " << ms << " ms, peak in-flight " << (peakBytes >> 10) << " KB\n";
+    }
+
+    //// 有界流水线：同时在途的令牌数量受限
+    {
+        peakBytes = 0;
+        size_t written = 0;
+        size_t next = 0;
+        auto begin = std::chrono::steady_clock::now();
+
+        Pipeline pipeline(pool);
+        pipeline.setSource<size_t>([&]() -> std::optional<size_t> {
+                    if(next == ITEM_COUNT) {
+                        return std::nullopt;
+                    }
+                    return next++;
+                })
+                .addStage<size_t, Block>(StageMode::PARALLEL, parse)
+                .addStage<Block, Block>(StageMode::PARALLEL, transform)
+                .addStage<Block, Block>(StageMode::PARALLEL, compress)
+                .addStage<Block, void>(StageMode::SERIAL_IN_ORDER, [&](Block b) {
+                    write(std::move(b), written);
+                });
+        pipeline.run(16);
+
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "bounded pipeline:   " << ms << " ms, peak in-flight " << (peakBytes >> 10) << " KB"
+                  << ", " << (written > 0 ? "OK" : "EMPTY") << "\n";
+    }
+
+    return 0;
+}
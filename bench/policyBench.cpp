@@ -0,0 +1,76 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <string>
+
+#include "threadpoolOpt.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 空任务吞吐量：提交tasks个空任务并等待全部完成，返回Mtasks/s
+template<typename Pool>
+double throughput(Pool& pool, size_t tasks) {
+    std::vector<std::future<void>> results;
+    results.reserve(tasks);
+
+    auto begin = Clock::now();
+    for(size_t i = 0; i < tasks; ++i) {
+        results.emplace_back(pool.submitTask([]() {}));
+    }
+    for(auto& result : results) {
+        result.get();
+    }
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+    return tasks / us;
+}
+
+// 往返时延：逐个提交空任务并等待其完成，返回平均往返时间（us）
+template<typename Pool>
+double roundTrip(Pool& pool, size_t rounds) {
+    auto begin = Clock::now();
+    for(size_t i = 0; i < rounds; ++i) {
+        pool.submitTask([]() {}).get();
+    }
+    return std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / rounds;
+}
+
+// 运行一组策略的两个场景
+template<typename Pool>
+void run(const std::string& name, size_t threads, size_t tasks, size_t rounds) {
+    Pool pool;
+    pool.start(threads);
+
+    // 预热
+    throughput(pool, tasks / 10);
+
+    double mtps = throughput(pool, tasks);
+    double rtt = roundTrip(pool, rounds);
+    std::cout << std::left << std::setw(36) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2) << mtps << " Mtasks/s"
+              << std::setw(10) << rtt << " us\n";
+}
+
+// 逐项对比各策略的开销：统计、任务队列容器、模式分支、空闲自旋
+int main(int argc, char* argv[])
+{
+    size_t tasks = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t rounds = argc > 2 ? std::stoul(argv[2]) : 20000;
+    size_t threads = 4;
+
+    std::cout << std::left << std::setw(36) << "policy"
+              << std::right << std::setw(19) << "throughput"
+              << std::setw(13) << "round trip" << "\n";
+
+    run<ThreadPool>("ThreadPool (deque/block/runtime/stats)", threads, tasks, rounds);
+    run<BasicThreadPool<DequeQueuePolicy, BlockingIdlePolicy, FixedGrowthPolicy, PoolStatsCollector>>(
+        "fixed growth", threads, tasks, rounds);
+    run<BasicThreadPool<DequeQueuePolicy, BlockingIdlePolicy, FixedGrowthPolicy, NullStatsCollector>>(
+        "fixed growth + no stats", threads, tasks, rounds);
+    run<BasicThreadPool<RingQueuePolicy, BlockingIdlePolicy, FixedGrowthPolicy, NullStatsCollector>>(
+        "ring queue + fixed + no stats", threads, tasks, rounds);
+    run<BasicThreadPool<RingQueuePolicy, SpinIdlePolicy, FixedGrowthPolicy, NullStatsCollector>>(
+        "ring queue + spin + fixed + no stats", threads, tasks, rounds);
+
+    return 0;
+}
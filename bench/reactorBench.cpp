@@ -0,0 +1,213 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+
+#include "threadpoolOpt.h"
+#include "reactor.h"
+
+const size_t MESSAGE_SIZE = 64;     // 每次往返的消息大小
+
+// 设置非阻塞
+void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+// 设置TCP_NODELAY，避免Nagle算法引入额外时延
+void setNoDelay(int fd) {
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+// 回显：读出所有可读数据并原样写回
+void echo(int fd) {
+    char buffer[4096];
+    for(;;) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if(n <= 0) {
+            return;
+        }
+        for(ssize_t sent = 0; sent < n; ) {
+            ssize_t m = write(fd, buffer + sent, n - sent);
+            if(m > 0) {
+                sent += m;
+            }
+        }
+    }
+}
+
+// 建立conns对回环连接，返回{客户端fd, 服务端fd}
+std::vector<std::pair<int, int>> connectPairs(size_t conns) {
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    listen(listenFd, static_cast<int>(conns));
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+
+    std::vector<std::pair<int, int>> pairs;
+    for(size_t i = 0; i < conns; ++i) {
+        int client = socket(AF_INET, SOCK_STREAM, 0);
+        connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        int server = accept(listenFd, nullptr, nullptr);
+        setNoDelay(client);
+        setNoDelay(server);
+        setNonBlocking(server);
+        pairs.emplace_back(client, server);
+    }
+    close(listenFd);
+    return pairs;
+}
+
+// 每个客户端连接一个线程，逐次发送消息并等待回显，返回所有往返时延（ns）
+std::vector<double> runClients(const std::vector<std::pair<int, int>>& pairs, size_t rounds) {
+    std::vector<std::vector<double>> samples(pairs.size());
+    std::vector<std::thread> clients;
+    for(size_t c = 0; c < pairs.size(); ++c) {
+        clients.emplace_back([&, c]() {
+            int fd = pairs[c].first;
+            char message[MESSAGE_SIZE] = {};
+            char reply[MESSAGE_SIZE];
+            samples[c].reserve(rounds);
+            for(size_t r = 0; r < rounds; ++r) {
+                auto begin = std::chrono::steady_clock::now();
+                write(fd, message, sizeof(message));
+                for(size_t got = 0; got < sizeof(reply); ) {
+                    ssize_t n = read(fd, reply + got, sizeof(reply) - got);
+                    if(n <= 0) {
+                        return;
+                    }
+                    got += n;
+                }
+                samples[c].push_back(std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - begin).count());
+            }
+        });
+    }
+    for(auto& t : clients) {
+        t.join();
+    }
+
+    std::vector<double> all;
+    for(auto& list : samples) {
+        all.insert(all.end(), list.begin(), list.end());
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+// 输出一行结果
+void report(const char* name, std::vector<double>& samples, double totalMs) {
+    auto at = [&](double q) {
+        return samples.empty() ? 0.0 : samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))] / 1e3;
+    };
+    std::cout << name << ": " << samples.size() / totalMs * 1e3 << " round trips/s"
+              << ", p50 " << at(0.50) << " us, p99 " << at(0.99) << " us\n";
+}
+
+// 独立epoll线程 + submitTask：就绪事件经任务队列交给工作线程处理
+void benchSubmit(size_t threads, size_t conns, size_t rounds) {
+    ThreadPool pool;
+    pool.start(threads);
+    auto pairs = connectPairs(conns);
+
+    int epollFd = epoll_create1(0);
+    for(auto& p : pairs) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.fd = p.second;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, p.second, &event);
+    }
+
+    std::atomic_bool running(true);
+    std::thread ioThread([&]() {
+        epoll_event events[64];
+        while(running) {
+            int n = epoll_wait(epollFd, events, 64, 10);
+            for(int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                pool.submitTask([epollFd, fd]() {
+                    echo(fd);
+
+                    // 处理完成后重新启用该fd
+                    epoll_event event{};
+                    event.events = EPOLLIN | EPOLLONESHOT;
+                    event.data.fd = fd;
+                    epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+                });
+            }
+        }
+    });
+
+    auto begin = std::chrono::steady_clock::now();
+    auto samples = runClients(pairs, rounds);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    report("epoll thread + submitTask", samples, ms);
+
+    running = false;
+    ioThread.join();
+    close(epollFd);
+    for(auto& p : pairs) {
+        close(p.first);
+        close(p.second);
+    }
+}
+
+// Reactor：空闲工作线程直接轮询epoll，回调在工作线程上执行
+void benchReactor(size_t threads, size_t conns, size_t rounds) {
+    ThreadPool pool;
+    pool.start(threads);
+    auto pairs = connectPairs(conns);
+
+    {
+        Reactor reactor(pool);
+        for(auto& p : pairs) {
+            int fd = p.second;
+            reactor.add(fd, EPOLLIN, [fd](uint32_t) {
+                echo(fd);
+            });
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        auto samples = runClients(pairs, rounds);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        report("reactor (inline on worker)", samples, ms);
+
+        for(auto& p : pairs) {
+            reactor.remove(p.second);
+        }
+    }
+
+    for(auto& p : pairs) {
+        close(p.first);
+        close(p.second);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t conns = argc > 1 ? std::stoul(argv[1]) : 8;
+    size_t rounds = argc > 2 ? std::stoul(argv[2]) : 5000;
+    size_t threads = 4;
+
+    std::cout << "loopback echo: " << conns << " connections x " << rounds << " round trips, "
+              << MESSAGE_SIZE << " bytes\n";
+    benchSubmit(threads, conns, rounds);
+    benchReactor(threads, conns, rounds);
+
+    return 0;
+}
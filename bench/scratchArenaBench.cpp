@@ -0,0 +1,162 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <new>
+#include <cstdlib>
+#include <memory_resource>
+
+#include "threadpoolOpt.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 统计全局operator new的调用次数
+// 数组与对齐版本一并替换，保证new/delete配对的分配函数一致；
+// 禁止内联，否则编译器在调用处看到malloc/free，误报-Wmismatched-new-delete
+static std::atomic<size_t> allocCount{0};
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if(void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+__attribute__((noinline)) void* operator new(size_t size, std::align_val_t alignment) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    // aligned_alloc要求大小为对齐的整数倍
+    size_t align = static_cast<size_t>(alignment);
+    if(void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+static const size_t TABLE_SIZE = 64 * 1024;     // 每个任务的哈希表项数（256KB）
+static const size_t TOKENS = 4096;              // 每个任务的切分结果数量
+
+// 模拟压缩/解析任务：清零一张哈希表，逐个追加切分结果，返回校验值
+template<typename Table, typename Tokens>
+size_t work(Table& table, Tokens& tokens, size_t seed) {
+    table.assign(TABLE_SIZE, 0);
+    for(size_t i = 0; i < TOKENS; ++i) {
+        size_t hash = (seed + i) * 2654435761u;
+        table[hash & (TABLE_SIZE - 1)]++;
+        tokens.push_back(hash);
+    }
+    return tokens.size() + table[seed & (TABLE_SIZE - 1)];
+}
+
+// 工作线程局部的临时缓冲区
+struct Scratch
+{
+    std::vector<uint32_t> table;
+    std::vector<size_t> tokens;
+};
+
+// 提交tasks个任务并等待完成，输出吞吐量与每个任务的operator new次数
+template<typename Func>
+void run(ThreadPool& pool, const std::string& name, size_t tasks, Func func) {
+    std::vector<std::future<size_t>> results;
+    results.reserve(tasks);
+
+    size_t allocBegin = allocCount.load();
+    auto begin = Clock::now();
+    for(size_t i = 0; i < tasks; ++i) {
+        results.emplace_back(pool.submitTask(func, i));
+    }
+    for(auto& result : results) {
+        result.get();
+    }
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+
+    // 包含提交本身（任务包装、future共享状态）的分配，与空任务的结果对比
+    size_t allocs = allocCount.load() - allocBegin;
+    std::cout << std::left << std::setw(28) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << tasks / us * 1e3 << " ktasks/s"
+              << std::setw(12) << std::setprecision(2) << static_cast<double>(allocs) / tasks << " new/task\n";
+}
+
+// 每个任务分配临时缓冲区与复用工作线程局部缓冲区/任务临时内存区的对比
+int main(int argc, char* argv[])
+{
+    size_t tasks = argc > 1 ? std::stoul(argv[1]) : 20000;
+
+    ThreadPool pool;
+    pool.setMode(PoolMode::MODE_FIXED);
+    pool.start(4);
+
+    std::cout << std::left << std::setw(28) << "scratch buffers"
+              << std::right << std::setw(21) << "throughput" << std::setw(21) << "allocations" << "\n";
+
+    // 空任务，只有提交本身的分配
+    run(pool, "empty task", tasks, [](size_t seed) {
+        return seed;
+    });
+
+    // 每个任务新建std::vector
+    run(pool, "std::vector per task", tasks, [](size_t seed) {
+        std::vector<uint32_t> table;
+        std::vector<size_t> tokens;
+        return work(table, tokens, seed);
+    });
+
+    // 工作线程局部对象，容量跨任务保留
+    run(pool, "pool.local<Scratch>()", tasks, [&pool](size_t seed) {
+        Scratch& scratch = pool.local<Scratch>();
+        scratch.tokens.clear();
+        return work(scratch.table, scratch.tokens, seed);
+    });
+
+    // 任务临时内存区，任务结束后整体回收
+    run(pool, "pool.scratchArena()", tasks, [&pool](size_t seed) {
+        std::pmr::vector<uint32_t> table(&pool.scratchArena());
+        std::pmr::vector<size_t> tokens(&pool.scratchArena());
+        return work(table, tokens, seed);
+    });
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+#ifndef __BENCHCOMMON_H__
+#define __BENCHCOMMON_H__
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+// 基准测试通用设施：命令行参数、计时、分位数与JSON输出
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+// 命令行参数
+struct Options
+{
+    int warmup = 1;                 // 预热次数，不计入结果
+    int repeat = 5;                 // 正式测量次数
+    size_t threads = 4;             // 线程池线程数量
+    double scale = 1.0;             // 任务数量缩放系数
+    std::string filter;             // 只运行名称包含该字符串的场景/变体
+    std::string output;             // JSON输出文件，为空时输出到标准输出
+};
+
+// 解析命令行参数
+inline Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if(i + 1 >= argc) {
+                std::cerr << "missing value for " << arg << "\n";
+                std::exit(EXIT_FAILURE);
+            }
+            return argv[++i];
+        };
+
+        if(arg == "--warmup") {
+            options.warmup = std::stoi(next());
+        }
+        else if(arg == "--repeat") {
+            options.repeat = std::stoi(next());
+        }
+        else if(arg == "--threads") {
+            options.threads = std::stoul(next());
+        }
+        else if(arg == "--scale") {
+            options.scale = std::stod(next());
+        }
+        else if(arg == "--filter") {
+            options.filter = next();
+        }
+        else if(arg == "--output") {
+            options.output = next();
+        }
+        else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--warmup N] [--repeat N] [--threads N] [--scale X] [--filter NAME] [--output FILE]\n";
+            std::exit(arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+    }
+    return options;
+}
+
+// 纳秒计时
+inline double elapsedNs(Clock::time_point begin, Clock::time_point end) {
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+// 忙等模拟计算量，单位：ns
+inline void spinFor(double ns) {
+    auto begin = Clock::now();
+    while(elapsedNs(begin, Clock::now()) < ns) {}
+}
+
+// 分位数，samples会被排序
+inline double percentile(std::vector<double>& samples, double q) {
+    if(samples.empty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()));
+    return samples[index];
+}
+
+// 单次测量结果：若干指标名与数值
+struct Metrics
+{
+    std::vector<std::pair<std::string, double>> values;
+
+    void add(const std::string& name, double value) {
+        values.emplace_back(name, value);
+    }
+};
+
+// JSON结果收集器
+class Report
+{
+public:
+    explicit Report(const Options& options)
+        : options_(options)
+    {}
+
+    // 记录一次测量结果
+    void add(const std::string& variant, const std::string& scenario, int repeat, const Metrics& metrics) {
+        std::ostringstream os;
+        os << "    {\"variant\": \"" << variant << "\", \"scenario\": \"" << scenario
+           << "\", \"repeat\": " << repeat;
+        for(auto& item : metrics.values) {
+            os << ", \"" << item.first << "\": " << item.second;
+        }
+        os << "}";
+        results_.emplace_back(os.str());
+
+        std::cerr << variant << " / " << scenario << " #" << repeat << "\n";
+    }
+
+    // 输出JSON
+    void write() const {
+        std::ostringstream os;
+        os << "{\n";
+        os << "  \"suite\": \"threadpool_bench\",\n";
+        os << "  \"config\": {\"warmup\": " << options_.warmup << ", \"repeat\": " << options_.repeat
+           << ", \"threads\": " << options_.threads << ", \"scale\": " << options_.scale << "},\n";
+        os << "  \"results\": [\n";
+        for(size_t i = 0; i < results_.size(); ++i) {
+            os << results_[i] << (i + 1 < results_.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n";
+        os << "}\n";
+
+        if(options_.output.empty()) {
+            std::cout << os.str();
+        }
+        else {
+            std::ofstream file(options_.output);
+            file << os.str();
+        }
+    }
+
+private:
+    const Options& options_;
+    std::vector<std::string> results_;
+};
+
+// 按预热/重复次数运行一个场景
+inline void runScenario(const Options& options, Report& report, const std::string& variant,
+                        const std::string& scenario, const std::function<Metrics()>& func) {
+    if(!options.filter.empty() &&
+       variant.find(options.filter) == std::string::npos &&
+       scenario.find(options.filter) == std::string::npos) {
+        return;
+    }
+
+    for(int i = 0; i < options.warmup; ++i) {
+        func();
+    }
+    for(int i = 0; i < options.repeat; ++i) {
+        report.add(variant, scenario, i, func());
+    }
+}
+
+} // namespace bench
+
+#endif
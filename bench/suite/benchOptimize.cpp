@@ -0,0 +1,42 @@
+#include <functional>
+#include <future>
+
+#include "threadpoolOpt.h"
+#include "benchScenarios.h"
+
+// Optimize线程池适配器
+class OptimizeAdapter
+{
+public:
+    using Handle = std::future<void>;
+
+    OptimizeAdapter(bool cached, size_t threads) {
+        pool_.setMode(cached ? PoolMode::MODE_CACHED : PoolMode::MODE_FIXED);
+        pool_.start(threads);
+    }
+
+    template<typename Func>
+    Handle submit(Func&& func) {
+        return pool_.submitTask(std::forward<Func>(func));
+    }
+
+    static void wait(Handle& handle) {
+        handle.get();
+    }
+
+private:
+    ThreadPool pool_;
+};
+
+int main(int argc, char* argv[])
+{
+    bench::Options options = bench::parseOptions(argc, argv);
+    bench::Report report(options);
+
+    // 新增的线程池模式在此注册为新的变体
+    bench::runSuite<OptimizeAdapter>(options, report, "optimize-fixed", false);
+    bench::runSuite<OptimizeAdapter>(options, report, "optimize-cached", true);
+
+    report.write();
+    return 0;
+}
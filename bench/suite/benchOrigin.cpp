@@ -0,0 +1,59 @@
+#include <functional>
+#include <memory>
+
+#include "threadpool.h"
+#include "benchScenarios.h"
+
+// 将任意可调用对象包装为Origin线程池的Task
+class FuncTask : public Task
+{
+public:
+    explicit FuncTask(std::function<void()> func)
+        : func_(std::move(func))
+    {}
+
+    virtual Any run() override {
+        func_();
+        return 0;
+    }
+
+private:
+    std::function<void()> func_;
+};
+
+// Origin线程池适配器
+class OriginAdapter
+{
+public:
+    // Result禁止拷贝与移动，通过智能指针持有
+    using Handle = std::unique_ptr<Result>;
+
+    OriginAdapter(bool cached, size_t threads) {
+        pool_.setMode(cached ? PoolMode::MODE_CACHED : PoolMode::MODE_FIXED);
+        pool_.start(threads);
+    }
+
+    template<typename Func>
+    Handle submit(Func&& func) {
+        return Handle(new Result(pool_.submitTask(std::make_shared<FuncTask>(std::forward<Func>(func)))));
+    }
+
+    static void wait(Handle& handle) {
+        handle->get();
+    }
+
+private:
+    ThreadPool pool_;
+};
+
+int main(int argc, char* argv[])
+{
+    bench::Options options = bench::parseOptions(argc, argv);
+    bench::Report report(options);
+
+    bench::runSuite<OriginAdapter>(options, report, "origin-fixed", false);
+    bench::runSuite<OriginAdapter>(options, report, "origin-cached", true);
+
+    report.write();
+    return 0;
+}
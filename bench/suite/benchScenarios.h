@@ -0,0 +1,207 @@
+#ifndef __BENCHSCENARIOS_H__
+#define __BENCHSCENARIOS_H__
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "benchCommon.h"
+
+// 标准化测试场景，以适配器屏蔽不同线程池实现的接口差异
+/*
+    适配器需要提供：
+        Adapter(bool cached, size_t threads)            创建并启动线程池
+        Handle submit(std::function<void()> func)       提交任务
+        static void wait(Handle& handle)                等待任务完成
+*/
+namespace bench {
+
+// 空任务吞吐量：单个生产者提交大量空任务
+template<typename Adapter>
+Metrics emptyTaskThroughput(const Options& options, bool cached) {
+    size_t tasks = static_cast<size_t>(200000 * options.scale);
+    Adapter pool(cached, options.threads);
+
+    std::vector<typename Adapter::Handle> handles;
+    handles.reserve(tasks);
+
+    auto begin = Clock::now();
+    for(size_t i = 0; i < tasks; ++i) {
+        handles.emplace_back(pool.submit([]() {}));
+    }
+    for(auto& handle : handles) {
+        Adapter::wait(handle);
+    }
+    double ns = elapsedNs(begin, Clock::now());
+
+    Metrics metrics;
+    metrics.add("tasks", tasks);
+    metrics.add("tasks_per_sec", tasks / (ns / 1e9));
+    metrics.add("ns_per_task", ns / tasks);
+    return metrics;
+}
+
+// 提交到开始执行的时延：线程池空闲时逐个提交任务
+template<typename Adapter>
+Metrics submitToStartLatency(const Options& options, bool cached) {
+    size_t tasks = static_cast<size_t>(5000 * options.scale);
+    Adapter pool(cached, options.threads);
+
+    std::vector<double> samples;
+    samples.reserve(tasks);
+    for(size_t i = 0; i < tasks; ++i) {
+        Clock::time_point startTime;
+        auto submitTime = Clock::now();
+        auto handle = pool.submit([&startTime]() {
+            startTime = Clock::now();
+        });
+        Adapter::wait(handle);
+        samples.push_back(elapsedNs(submitTime, startTime));
+    }
+
+    Metrics metrics;
+    metrics.add("tasks", tasks);
+    metrics.add("p50_ns", percentile(samples, 0.50));
+    metrics.add("p90_ns", percentile(samples, 0.90));
+    metrics.add("p99_ns", percentile(samples, 0.99));
+    metrics.add("p999_ns", percentile(samples, 0.999));
+    metrics.add("max_ns", samples.back());
+    return metrics;
+}
+
+// 扇出/扇入：每轮提交一批约1us的任务并等待全部完成
+template<typename Adapter>
+Metrics fanOutFanIn(const Options& options, bool cached) {
+    size_t rounds = static_cast<size_t>(500 * options.scale);
+    size_t width = options.threads * 8;
+    Adapter pool(cached, options.threads);
+
+    std::vector<typename Adapter::Handle> handles;
+    handles.reserve(width);
+
+    auto begin = Clock::now();
+    for(size_t r = 0; r < rounds; ++r) {
+        handles.clear();
+        for(size_t i = 0; i < width; ++i) {
+            handles.emplace_back(pool.submit([]() {
+                spinFor(1000);
+            }));
+        }
+        for(auto& handle : handles) {
+            Adapter::wait(handle);
+        }
+    }
+    double ns = elapsedNs(begin, Clock::now());
+
+    Metrics metrics;
+    metrics.add("rounds", rounds);
+    metrics.add("width", width);
+    metrics.add("rounds_per_sec", rounds / (ns / 1e9));
+    metrics.add("us_per_round", ns / rounds / 1e3);
+    return metrics;
+}
+
+// 生产者竞争：多个生产者线程同时提交空任务
+template<typename Adapter>
+Metrics producerContention(const Options& options, bool cached) {
+    size_t producers = std::max<size_t>(options.threads, 2);
+    size_t perProducer = static_cast<size_t>(50000 * options.scale);
+    Adapter pool(cached, options.threads);
+
+    std::atomic_bool go(false);
+    std::vector<std::thread> threads;
+    std::vector<std::vector<typename Adapter::Handle>> handles(producers);
+    for(size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            handles[p].reserve(perProducer);
+            while(!go) {
+                std::this_thread::yield();
+            }
+            for(size_t i = 0; i < perProducer; ++i) {
+                handles[p].emplace_back(pool.submit([]() {}));
+            }
+        });
+    }
+
+    auto begin = Clock::now();
+    go = true;
+    for(auto& t : threads) {
+        t.join();
+    }
+    double submitNs = elapsedNs(begin, Clock::now());
+    for(auto& list : handles) {
+        for(auto& handle : list) {
+            Adapter::wait(handle);
+        }
+    }
+    double ns = elapsedNs(begin, Clock::now());
+
+    size_t tasks = producers * perProducer;
+    Metrics metrics;
+    metrics.add("producers", producers);
+    metrics.add("tasks", tasks);
+    metrics.add("tasks_per_sec", tasks / (ns / 1e9));
+    metrics.add("submit_ns_per_task", submitNs / tasks);
+    return metrics;
+}
+
+// cached模式突发：多轮突发提交1ms的阻塞任务，测量每轮完成时间
+template<typename Adapter>
+Metrics cachedBurst(const Options& options, bool cached) {
+    size_t bursts = 5;
+    size_t burstSize = static_cast<size_t>(options.threads * 16 * options.scale);
+    Adapter pool(cached, options.threads);
+
+    std::vector<double> samples;
+    std::vector<typename Adapter::Handle> handles;
+    for(size_t b = 0; b < bursts; ++b) {
+        handles.clear();
+        auto begin = Clock::now();
+        for(size_t i = 0; i < burstSize; ++i) {
+            handles.emplace_back(pool.submit([]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }));
+        }
+        for(auto& handle : handles) {
+            Adapter::wait(handle);
+        }
+        samples.push_back(elapsedNs(begin, Clock::now()));
+
+        // 两轮突发之间留出间隔
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    Metrics metrics;
+    metrics.add("burst_size", burstSize);
+    metrics.add("burst_p50_ms", percentile(samples, 0.5) / 1e6);
+    metrics.add("burst_max_ms", samples.back() / 1e6);
+    return metrics;
+}
+
+// 针对一个线程池变体运行全部场景
+template<typename Adapter>
+void runSuite(const Options& options, Report& report, const std::string& variant, bool cached) {
+    runScenario(options, report, variant, "empty_task_throughput", [&]() {
+        return emptyTaskThroughput<Adapter>(options, cached);
+    });
+    runScenario(options, report, variant, "submit_to_start_latency", [&]() {
+        return submitToStartLatency<Adapter>(options, cached);
+    });
+    runScenario(options, report, variant, "fan_out_fan_in", [&]() {
+        return fanOutFanIn<Adapter>(options, cached);
+    });
+    runScenario(options, report, variant, "producer_contention", [&]() {
+        return producerContention<Adapter>(options, cached);
+    });
+    if(cached) {
+        runScenario(options, report, variant, "cached_burst", [&]() {
+            return cachedBurst<Adapter>(options, cached);
+        });
+    }
+}
+
+} // namespace bench
+
+#endif
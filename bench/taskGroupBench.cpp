@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+
+#include "threadpoolOpt.h"
+#include "taskGroup.h"
+
+// 串行阈值，低于该规模时不再拆分任务
+const int FIB_CUTOFF  = 20;
+const size_t SORT_CUTOFF = 4096;
+
+// 串行斐波那契
+long long fibSerial(int n) {
+    return n < 2 ? n : fibSerial(n - 1) + fibSerial(n - 2);
+}
+
+// 基于任务组的递归斐波那契，递归深度远超线程数量
+long long fibParallel(ThreadPool& pool, int n) {
+    if(n < FIB_CUTOFF) {
+        return fibSerial(n);
+    }
+
+    long long x = 0;
+    long long y = 0;
+
+    // 子任务直接引用当前栈帧上的x，任务组保证其在析构前完成
+    TaskGroup group(pool);
+    group.run([&]() {
+        x = fibParallel(pool, n - 1);
+    });
+    y = fibParallel(pool, n - 2);
+    group.wait();
+
+    return x + y;
+}
+
+// 基于任务组的递归快速排序
+void quickSortParallel(ThreadPool& pool, int* first, int* last) {
+    if(static_cast<size_t>(last - first) < SORT_CUTOFF) {
+        std::sort(first, last);
+        return;
+    }
+
+    int pivot = first[(last - first) / 2];
+    int* middle1 = std::partition(first, last, [pivot](int v) { return v < pivot; });
+    int* middle2 = std::partition(middle1, last, [pivot](int v) { return !(pivot < v); });
+
+    TaskGroup group(pool);
+    group.run([&pool, first, middle1]() {
+        quickSortParallel(pool, first, middle1);
+    });
+    quickSortParallel(pool, middle2, last);
+    group.wait();
+}
+
+// 计时工具
+template<typename Func>
+double timeMs(Func&& func) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int main()
+{
+    // 固定4个线程，递归深度远大于线程数量
+    ThreadPool pool;
+    pool.setMode(PoolMode::MODE_FIXED);
+    pool.start(4);
+
+    // 斐波那契
+    const int n = 34;
+    long long serial = 0;
+    long long parallel = 0;
+    double serialMs = timeMs([&]() { serial = fibSerial(n); });
+    double parallelMs = timeMs([&]() {
+        // 从工作线程中发起，验证工作线程内部等待不会死锁
+        parallel = pool.submitTask(fibParallel, std::ref(pool), n).get();
+    });
+    std::cout << "fib(" << n << ") serial: " << serialMs << " ms, taskgroup: " << parallelMs
+              << " ms, " << (serial == parallel ? "OK" : "MISMATCH") << "\n";
+
+    // 快速排序
+    std::vector<int> data(1 << 24);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist;
+    for(auto& v : data) {
+        v = dist(gen);
+    }
+    std::vector<int> expected = data;
+
+    serialMs = timeMs([&]() { std::sort(expected.begin(), expected.end()); });
+    parallelMs = timeMs([&]() {
+        pool.submitTask([&]() {
+            quickSortParallel(pool, data.data(), data.data() + data.size());
+        }).get();
+    });
+    std::cout << "quicksort(" << data.size() << ") std::sort: " << serialMs << " ms, taskgroup: " << parallelMs
+              << " ms, " << (data == expected ? "OK" : "MISMATCH") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "threadpoolOpt.h"
+
+const size_t THREADS = 1024;                    // cached模式扩容到的线程数量
+const size_t TOUCHED_STACK = 128 * 1024;        // 每个任务使用的栈大小
+
+// 读取/proc/self/status中的字段，单位：kB
+long readStatus(const std::string& key) {
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while(std::getline(file, line)) {
+        if(line.compare(0, key.size() + 1, key + ":") == 0) {
+            std::istringstream is(line.substr(key.size() + 1));
+            long value = 0;
+            is >> value;
+            return value;
+        }
+    }
+    return 0;
+}
+
+// 使用一段栈空间后短暂阻塞，使cached模式为每个任务创建线程
+void touchStack() {
+    volatile char buffer[TOUCHED_STACK];
+    for(size_t i = 0; i < TOUCHED_STACK; i += 4096) {
+        buffer[i] = 1;
+    }
+    // 读回一个元素，避免写入被视为无用
+    (void)buffer[0];
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+}
+
+// 输出当前线程数、虚拟内存与常驻内存
+void report(const char* config, const char* phase) {
+    std::cout << config << " / " << phase << ": threads " << readStatus("Threads")
+              << ", VmSize " << readStatus("VmSize") / 1024 << " MB"
+              << ", VmRSS " << readStatus("VmRSS") / 1024 << " MB\n";
+}
+
+// 在子进程中运行一种配置，避免不同配置之间的内存相互影响
+void runConfig(const char* config, size_t stackSize, size_t guardSize, bool releaseIdleStack) {
+    // 先刷新输出缓冲区，避免子进程重复输出
+    std::cout.flush();
+    pid_t pid = fork();
+    if(pid != 0) {
+        waitpid(pid, nullptr, 0);
+        return;
+    }
+
+    {
+        ThreadPool pool;
+        pool.setMode(PoolMode::MODE_CACHED);
+        pool.setThreadSizeThreshold(THREADS);
+        pool.setThreadStack(stackSize, guardSize);
+        pool.setIdleStackRelease(releaseIdleStack);
+        pool.start(4);
+
+        std::vector<std::future<void>> results;
+        for(size_t i = 0; i < THREADS; ++i) {
+            results.emplace_back(pool.submitTask(touchStack));
+        }
+        for(auto& result : results) {
+            result.get();
+        }
+        report(config, "after burst");
+
+        // 等待空闲线程释放栈内存
+        std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+        report(config, "parked 2.5s");
+    }
+
+    std::cout.flush();
+    _exit(0);
+}
+
+int main()
+{
+    std::cout << THREADS << " cached threads, each task touches " << TOUCHED_STACK / 1024 << " KB of stack\n";
+    runConfig("default 8MB stack", 0, 0, false);
+    runConfig("256KB stack", 256 * 1024, 4096, false);
+    runConfig("256KB stack + idle release", 256 * 1024, 4096, true);
+    return 0;
+}
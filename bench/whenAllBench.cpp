@@ -0,0 +1,86 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <future>
+
+#include "threadpoolOpt.h"
+#include "whenAll.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 计时工具，返回ms
+template<typename Func>
+double timeMs(Func&& func) {
+    auto begin = Clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+// 提交n个小任务
+std::vector<TaskFuture<int>> submitAll(ThreadPool& pool, size_t n) {
+    std::vector<TaskFuture<int>> futures;
+    futures.reserve(n);
+    for(size_t i = 0; i < n; ++i) {
+        futures.emplace_back(pool.submitTask([i]() { return static_cast<int>(i & 0xff); }));
+    }
+    return futures;
+}
+
+// 聚合n个future：逐个get()与when_all/when_any对比
+int main(int argc, char* argv[])
+{
+    size_t threads = argc > 1 ? std::stoul(argv[1]) : 4;
+
+    ThreadPool pool;
+    pool.start(threads);
+
+    for(size_t n : { 1000, 10000, 100000 }) {
+        long sum = 0;
+
+        // 逐个阻塞get()
+        double getMs = timeMs([&]() {
+            auto futures = submitAll(pool, n);
+            for(auto& future : futures) {
+                sum += future.get();
+            }
+        });
+
+        // when_all：由最后完成的工作线程写入结果，调用线程只等待一次
+        double allMs = timeMs([&]() {
+            auto futures = submitAll(pool, n);
+            auto all = when_all(futures.begin(), futures.end()).get();
+            for(auto& future : all) {
+                sum += future.get();
+            }
+        });
+
+        // when_all + 完成回调：调用线程不阻塞，回调在工作线程上执行
+        double thenMs = timeMs([&]() {
+            std::promise<void> done;
+            auto futures = submitAll(pool, n);
+            when_all(futures.begin(), futures.end()).onComplete([&done]() {
+                done.set_value();
+            });
+            done.get_future().wait();
+        });
+
+        // when_any：首个完成的任务写入结果
+        double anyMs = timeMs([&]() {
+            auto futures = submitAll(pool, n);
+            auto any = when_any(futures.begin(), futures.end()).get();
+            // 等待其余任务结束，避免影响下一轮测量
+            for(auto& future : any.futures) {
+                sum += future.get();
+            }
+        });
+
+        std::cout << "n=" << n
+                  << "\tget() loop " << getMs << " ms"
+                  << "\twhen_all " << allMs << " ms"
+                  << "\twhen_all+onComplete " << thenMs << " ms"
+                  << "\twhen_any " << anyMs << " ms"
+                  << "\t(" << sum << ")\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,370 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <sys/resource.h>
+
+#include "threadpoolOpt.h"
+#include "taskGroup.h"
+#include "benchCommon.h"
+
+//// 基于配置文件的工作负载模拟器
+/*
+    按配置文件描述的任务时长分布、阻塞任务比例、到达过程、嵌套深度与生产者数量生成负载，
+    在每种PoolMode以及每组线程数上限/任务队列上限下回放，输出吞吐量、尾延迟与CPU时间，
+    用于选择setThreadSizeThreshold与setTaskQueMaxThreshold的取值
+
+    配置文件格式（key = value，#开头为注释），示例见bench/workloads/mixed.conf：
+        tasks           = 20000                     # 顶层任务总数
+        producers       = 4                         # 生产者线程数
+        threads         = 4                         # 初始线程数
+        duration        = lognormal 3.0 1.0         # 计算时长分布，单位：us
+                          pareto 5 1.5 | bimodal 0.9 5 500 | exponential 50 | fixed 10
+        blocking        = 0.1 1000                  # 阻塞任务比例与阻塞时长（us）
+        arrival         = poisson 20000             # 到达过程：poisson 速率(每秒) | bursty 速率 突发大小
+        nesting         = 2 2                       # 嵌套深度与每层子任务数量
+        modes           = fixed,cached              # 待评估的线程池模式
+        thread_max      = 64,1024                   # cached模式线程数上限的候选值
+        queue_max       = 1000,2147483647           # 任务队列上限的候选值
+        seed            = 42
+*/
+
+// 工作负载配置
+struct WorkloadConfig
+{
+    size_t tasks = 20000;
+    size_t producers = 4;
+    size_t threads = 4;
+    std::vector<std::string> duration = { "exponential", "50" };
+    double blockingFraction = 0.0;
+    double blockingUs = 1000;
+    std::vector<std::string> arrival = { "poisson", "20000" };
+    size_t nestingDepth = 0;
+    size_t nestingFanout = 2;
+    std::vector<std::string> modes = { "fixed", "cached" };
+    std::vector<size_t> threadMax = { THREAD_MAX_THRESHOLD };
+    std::vector<size_t> queueMax = { TASK_MAX_THRESHOLD };
+    unsigned seed = 42;
+};
+
+// 按空白或逗号切分
+std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> items;
+    std::string item;
+    for(char c : text) {
+        if(c == ' ' || c == '\t' || c == ',') {
+            if(!item.empty()) {
+                items.push_back(item);
+                item.clear();
+            }
+        }
+        else {
+            item += c;
+        }
+    }
+    if(!item.empty()) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+// 解析配置文件
+WorkloadConfig loadConfig(const std::string& path) {
+    std::ifstream file(path);
+    if(!file) {
+        std::cerr << "cannot open workload config: " << path << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    WorkloadConfig config;
+    std::string line;
+    while(std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        size_t eq = line.find('=');
+        if(eq == std::string::npos) {
+            continue;
+        }
+
+        std::vector<std::string> keys = split(line.substr(0, eq));
+        std::vector<std::string> values = split(line.substr(eq + 1));
+        if(keys.empty() || values.empty()) {
+            continue;
+        }
+
+        const std::string& key = keys[0];
+        if(key == "tasks") {
+            config.tasks = std::stoul(values[0]);
+        }
+        else if(key == "producers") {
+            config.producers = std::max<size_t>(std::stoul(values[0]), 1);
+        }
+        else if(key == "threads") {
+            config.threads = std::stoul(values[0]);
+        }
+        else if(key == "duration") {
+            config.duration = values;
+        }
+        else if(key == "blocking") {
+            config.blockingFraction = std::stod(values[0]);
+            if(values.size() > 1) {
+                config.blockingUs = std::stod(values[1]);
+            }
+        }
+        else if(key == "arrival") {
+            config.arrival = values;
+        }
+        else if(key == "nesting") {
+            config.nestingDepth = std::stoul(values[0]);
+            if(values.size() > 1) {
+                config.nestingFanout = std::stoul(values[1]);
+            }
+        }
+        else if(key == "modes") {
+            config.modes = values;
+        }
+        else if(key == "thread_max") {
+            config.threadMax.clear();
+            for(auto& v : values) {
+                config.threadMax.push_back(std::stoul(v));
+            }
+        }
+        else if(key == "queue_max") {
+            config.queueMax.clear();
+            for(auto& v : values) {
+                config.queueMax.push_back(std::stoul(v));
+            }
+        }
+        else if(key == "seed") {
+            config.seed = std::stoul(values[0]);
+        }
+        else {
+            std::cerr << "unknown key in workload config: " << key << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    return config;
+}
+
+// 任务时长分布，单位：us
+class DurationDist
+{
+public:
+    explicit DurationDist(const std::vector<std::string>& spec)
+        : spec_(spec)
+    {
+        auto arg = [&](size_t i) { return i < spec.size() ? std::stod(spec[i]) : 0.0; };
+        kind_ = spec[0];
+        if(kind_ == "lognormal") {
+            lognormal_ = std::lognormal_distribution<double>(arg(1), arg(2));
+        }
+        else if(kind_ == "pareto") {
+            xm_ = arg(1);
+            alpha_ = arg(2);
+        }
+        else if(kind_ == "bimodal") {
+            p_ = arg(1);
+            fast_ = arg(2);
+            slow_ = arg(3);
+        }
+        else if(kind_ == "exponential") {
+            exponential_ = std::exponential_distribution<double>(1.0 / arg(1));
+        }
+        else if(kind_ == "fixed") {
+            fast_ = arg(1);
+        }
+        else {
+            std::cerr << "unknown duration distribution: " << kind_ << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    double sample(std::mt19937_64& gen) {
+        if(kind_ == "lognormal") {
+            return lognormal_(gen);
+        }
+        if(kind_ == "pareto") {
+            // 逆变换采样，重尾分布
+            double u = uniform_(gen);
+            return xm_ / std::pow(1.0 - u, 1.0 / alpha_);
+        }
+        if(kind_ == "bimodal") {
+            return uniform_(gen) < p_ ? fast_ : slow_;
+        }
+        if(kind_ == "exponential") {
+            return exponential_(gen);
+        }
+        return fast_;
+    }
+
+private:
+    std::vector<std::string> spec_;
+    std::string kind_;
+    std::lognormal_distribution<double> lognormal_;
+    std::exponential_distribution<double> exponential_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+    double xm_ = 0, alpha_ = 1, p_ = 0, fast_ = 0, slow_ = 0;
+};
+
+// 预先生成的任务描述，保证各配置回放完全相同的负载
+struct TaskSpec
+{
+    double computeUs;       // 计算时长
+    double blockUs;         // 阻塞时长，0表示非阻塞任务
+    double arrivalUs;       // 相对开始时间的到达时刻
+};
+
+std::vector<TaskSpec> generate(const WorkloadConfig& config) {
+    std::mt19937_64 gen(config.seed);
+    DurationDist duration(config.duration);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    double rate = config.arrival.size() > 1 ? std::stod(config.arrival[1]) : 10000;
+    size_t burst = config.arrival.size() > 2 ? std::stoul(config.arrival[2]) : 1;
+    bool bursty = config.arrival[0] == "bursty";
+    std::exponential_distribution<double> interArrival(rate / 1e6);
+
+    std::vector<TaskSpec> specs(config.tasks);
+    double now = 0;
+    for(size_t i = 0; i < config.tasks; ++i) {
+        if(bursty) {
+            // 突发到达：每burst个任务同时到达，突发之间的间隔保持平均速率不变
+            if(i % burst == 0) {
+                now += burst * 1e6 / rate;
+            }
+        }
+        else {
+            now += interArrival(gen);
+        }
+
+        specs[i].computeUs = duration.sample(gen);
+        specs[i].blockUs = uniform(gen) < config.blockingFraction ? config.blockingUs : 0;
+        specs[i].arrivalUs = now;
+    }
+    return specs;
+}
+
+// 执行一个任务：计算、阻塞，并按嵌套深度派生子任务
+void execTask(ThreadPool& pool, const TaskSpec& spec, size_t depth, const WorkloadConfig& config) {
+    bench::spinFor(spec.computeUs * 1e3);
+    if(spec.blockUs > 0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(spec.blockUs));
+    }
+
+    if(depth > 0) {
+        // 子任务时长为父任务的1/fanout，通过任务组等待，避免阻塞工作线程
+        TaskSpec child = { spec.computeUs / config.nestingFanout, 0, 0 };
+        TaskGroup group(pool);
+        for(size_t i = 0; i < config.nestingFanout; ++i) {
+            group.run([&pool, child, depth, &config]() {
+                execTask(pool, child, depth - 1, config);
+            });
+        }
+        group.wait();
+    }
+}
+
+// 进程CPU时间（用户态+内核态），单位：s
+double cpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+         + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+// 在一组线程池参数下回放负载
+void replay(const WorkloadConfig& config, const std::vector<TaskSpec>& specs,
+            const std::string& mode, size_t threadMax, size_t queueMax) {
+    std::vector<double> latencies(specs.size(), -1);
+    std::atomic_size_t completed(0);
+    double cpuBegin = cpuSeconds();
+    auto begin = bench::Clock::now();
+
+    {
+        ThreadPool pool;
+        pool.setMode(mode == "cached" ? PoolMode::MODE_CACHED : PoolMode::MODE_FIXED);
+        pool.setThreadSizeThreshold(threadMax);
+        pool.setTaskQueMaxThreshold(queueMax);
+        pool.start(config.threads);
+
+        // 每个生产者按到达时刻提交属于自己的任务
+        std::vector<std::thread> producers;
+        for(size_t p = 0; p < config.producers; ++p) {
+            producers.emplace_back([&, p]() {
+                for(size_t i = p; i < specs.size(); i += config.producers) {
+                    auto arrival = begin + std::chrono::duration_cast<bench::Clock::duration>(
+                        std::chrono::duration<double, std::micro>(specs[i].arrivalUs));
+                    std::this_thread::sleep_until(arrival);
+
+                    pool.submitTask([&, i, arrival]() {
+                        execTask(pool, specs[i], config.nestingDepth, config);
+                        latencies[i] = bench::elapsedNs(arrival, bench::Clock::now());
+                        completed++;
+                    });
+                }
+            });
+        }
+        for(auto& t : producers) {
+            t.join();
+        }
+
+        // 析构函数等待队列中的任务全部执行完毕
+    }
+
+    double seconds = bench::elapsedNs(begin, bench::Clock::now()) / 1e9;
+    double cpu = cpuSeconds() - cpuBegin;
+
+    // 超时被拒绝的任务不会执行，不计入延迟统计
+    std::vector<double> samples;
+    for(double v : latencies) {
+        if(v >= 0) {
+            samples.push_back(v);
+        }
+    }
+
+    std::cout << mode
+              << "\t" << threadMax
+              << "\t" << queueMax
+              << "\t" << completed / seconds
+              << "\t" << specs.size() - completed
+              << "\t" << bench::percentile(samples, 0.50) / 1e3
+              << "\t" << bench::percentile(samples, 0.99) / 1e3
+              << "\t" << bench::percentile(samples, 0.999) / 1e3
+              << "\t" << cpu
+              << "\t" << cpu / seconds
+              << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <workload.conf>\n";
+        return EXIT_FAILURE;
+    }
+
+    WorkloadConfig config = loadConfig(argv[1]);
+    std::vector<TaskSpec> specs = generate(config);
+
+    std::cout << "mode\tthread_max\tqueue_max\tthroughput/s\trejected\tp50_us\tp99_us\tp999_us\tcpu_s\tcpu_cores\n";
+    for(auto& mode : config.modes) {
+        for(size_t queueMax : config.queueMax) {
+            if(mode == "cached") {
+                for(size_t threadMax : config.threadMax) {
+                    replay(config, specs, mode, threadMax, queueMax);
+                }
+            }
+            else {
+                // fixed模式下线程数上限不生效
+                replay(config, specs, mode, config.threads, queueMax);
+            }
+        }
+    }
+
+    return 0;
+}
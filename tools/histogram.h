@@ -0,0 +1,106 @@
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+// 对数分桶直方图（HDR风格），单位：ns
+/*
+    - 小于8的值各占一个桶，之后每个2的幂区间再细分为8个子桶，相对误差不超过12.5%
+    - 记录操作只有一次原子加法，可在多线程中无锁并发记录
+*/
+class LogHistogram
+{
+public:
+    static const int SUB_BUCKET_BITS = 3;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    // 记录一个值
+    void record(uint64_t value) {
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // 值所在的桶
+    static int bucketIndex(uint64_t value) {
+        if(value < SUB_BUCKET_COUNT) {
+            return static_cast<int>(value);
+        }
+
+        int msb = 63 - __builtin_clzll(value);
+        int group = msb - SUB_BUCKET_BITS + 1;
+        int sub = static_cast<int>((value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1));
+        return group * SUB_BUCKET_COUNT + sub;
+    }
+
+    // 桶的上界（不包含）
+    static uint64_t bucketUpperBound(int index) {
+        int group = index / SUB_BUCKET_COUNT;
+        uint64_t sub = index % SUB_BUCKET_COUNT;
+        if(group == 0) {
+            return sub + 1;
+        }
+
+        // 最高的几个桶的上界超出uint64_t范围
+        if(group - 1 + SUB_BUCKET_BITS + 1 >= 64) {
+            return UINT64_MAX;
+        }
+        return (SUB_BUCKET_COUNT + sub + 1) << (group - 1);
+    }
+
+    // 累加到快照中
+    void addTo(std::vector<uint64_t>& buckets, uint64_t& sum) const {
+        for(int i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] += buckets_[i].load(std::memory_order_relaxed);
+        }
+        sum += sum_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT] = {};     // 各桶计数
+    std::atomic<uint64_t> sum_{0};                          // 所有值之和
+};
+
+// 直方图快照
+struct HistogramSnapshot
+{
+    HistogramSnapshot()
+        : buckets(LogHistogram::BUCKET_COUNT, 0)
+        , count(0)
+        , sum(0)
+    {}
+
+    // 计算分位数，q取值[0, 1]，返回所在桶的上界
+    uint64_t percentile(double q) const {
+        if(count == 0) {
+            return 0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(q * count);
+        if(target >= count) {
+            target = count - 1;
+        }
+
+        uint64_t seen = 0;
+        for(int i = 0; i < LogHistogram::BUCKET_COUNT; ++i) {
+            seen += buckets[i];
+            if(seen > target) {
+                return LogHistogram::bucketUpperBound(i);
+            }
+        }
+        return LogHistogram::bucketUpperBound(LogHistogram::BUCKET_COUNT - 1);
+    }
+
+    // 平均值
+    double mean() const {
+        return count == 0 ? 0.0 : static_cast<double>(sum) / count;
+    }
+
+    std::vector<uint64_t> buckets;  // 各桶计数
+    uint64_t count;                 // 总次数
+    uint64_t sum;                   // 所有值之和，单位：ns
+};
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef __LOCKPROFILER_H__
+#define __LOCKPROFILER_H__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+
+#include "histogram.h"
+
+#ifndef LOCK_PROFILE_ENABLED
+#define LOCK_PROFILE_ENABLED 0  // 1: 启用锁竞争统计, 0: 禁用
+#endif
+
+// 锁竞争统计 - 按加锁位置（site）汇总
+/*
+    - 同名site的所有互斥锁实例共享一份统计，例如所有Semaphore::mtx_
+    - 记录加锁次数、发生竞争的次数、等待时间与持有时间的对数直方图
+    - report()按总等待时间从大到小输出
+*/
+class LockProfiler
+{
+public:
+    // 单个加锁位置的统计
+    struct Site
+    {
+        explicit Site(const std::string& siteName)
+            : name(siteName)
+        {}
+
+        std::string name;                       // 加锁位置名称
+        std::atomic<uint64_t> acquisitions{0};  // 加锁次数
+        std::atomic<uint64_t> contended{0};     // 发生竞争（try_lock失败）的次数
+        LogHistogram waitTime;                  // 等待时间，单位：ns
+        LogHistogram holdTime;                  // 持有时间，单位：ns
+    };
+
+    // 获取加锁位置的统计，不存在时创建
+    static Site* site(const char* name) {
+        LockProfiler& profiler = instance();
+        std::lock_guard<std::mutex> lock(profiler.mtx_);
+        auto& ptr = profiler.sites_[name];
+        if(ptr == nullptr) {
+            ptr = std::make_unique<Site>(name);
+        }
+        return ptr.get();
+    }
+
+    // 生成按总等待时间排序的报告
+    static std::string report() {
+        struct Row
+        {
+            std::string name;
+            uint64_t acquisitions;
+            uint64_t contended;
+            HistogramSnapshot wait;
+            HistogramSnapshot hold;
+        };
+
+        std::vector<Row> rows;
+        {
+            LockProfiler& profiler = instance();
+            std::lock_guard<std::mutex> lock(profiler.mtx_);
+            for(auto& item : profiler.sites_) {
+                Site& site = *item.second;
+                Row row;
+                row.name = site.name;
+                row.acquisitions = site.acquisitions.load(std::memory_order_relaxed);
+                row.contended = site.contended.load(std::memory_order_relaxed);
+                site.waitTime.addTo(row.wait.buckets, row.wait.sum);
+                site.holdTime.addTo(row.hold.buckets, row.hold.sum);
+                row.wait.count = row.acquisitions;
+                row.hold.count = row.acquisitions;
+                rows.emplace_back(std::move(row));
+            }
+        }
+
+        std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+            return a.wait.sum > b.wait.sum;
+        });
+
+        std::ostringstream os;
+        os << std::left << std::setw(32) << "site"
+           << std::right << std::setw(12) << "acquire"
+           << std::setw(12) << "contended"
+           << std::setw(14) << "wait_total_ms"
+           << std::setw(12) << "wait_p50_ns"
+           << std::setw(12) << "wait_p99_ns"
+           << std::setw(12) << "hold_p50_ns"
+           << std::setw(12) << "hold_p99_ns" << "\n";
+        for(auto& row : rows) {
+            os << std::left << std::setw(32) << row.name
+               << std::right << std::setw(12) << row.acquisitions
+               << std::setw(12) << row.contended
+               << std::setw(14) << std::fixed << std::setprecision(3) << row.wait.sum / 1e6
+               << std::setw(12) << row.wait.percentile(0.50)
+               << std::setw(12) << row.wait.percentile(0.99)
+               << std::setw(12) << row.hold.percentile(0.50)
+               << std::setw(12) << row.hold.percentile(0.99) << "\n";
+        }
+        return os.str();
+    }
+
+private:
+    LockProfiler() = default;
+
+    static LockProfiler& instance() {
+        static LockProfiler profiler;
+        return profiler;
+    }
+
+    std::mutex mtx_;                                                // 保证统计容器的线程安全
+    std::unordered_map<std::string, std::unique_ptr<Site>> sites_;  // 各加锁位置的统计
+};
+
+// 带竞争统计的互斥锁，满足Lockable要求，需配合std::condition_variable_any使用
+class ProfiledMutex
+{
+public:
+    explicit ProfiledMutex(const char* siteName)
+        : site_(LockProfiler::site(siteName))
+    {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        // 先尝试无等待加锁，失败时才计时，区分竞争与非竞争加锁
+        if(mtx_.try_lock()) {
+            site_->waitTime.record(0);
+        }
+        else {
+            auto begin = Clock::now();
+            mtx_.lock();
+            site_->contended.fetch_add(1, std::memory_order_relaxed);
+            site_->waitTime.record(toNs(Clock::now() - begin));
+        }
+        onAcquired();
+    }
+
+    bool try_lock() {
+        if(!mtx_.try_lock()) {
+            return false;
+        }
+        site_->waitTime.record(0);
+        onAcquired();
+        return true;
+    }
+
+    // 解锁后本对象可能已被其它线程析构（如线程池析构函数在最后一个工作线程解锁后返回），
+    // 因此在解锁前记录持有时间，解锁后不再访问任何成员
+    void unlock() {
+        site_->holdTime.record(toNs(Clock::now() - holdBegin_));
+        mtx_.unlock();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void onAcquired() {
+        holdBegin_ = Clock::now();
+        site_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<typename Duration>
+    static uint64_t toNs(Duration duration) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
+    std::mutex mtx_;                    // 实际的互斥锁
+    LockProfiler::Site* site_;          // 所属加锁位置的统计
+    Clock::time_point holdBegin_;       // 本次加锁成功的时间，仅由持有者读写
+};
+
+// 未开启统计时使用的互斥锁，仅接收加锁位置名称，其余与std::mutex完全相同
+class NamedMutex : public std::mutex
+{
+public:
+    explicit NamedMutex(const char*) {}
+};
+
+// 根据编译选项选择加锁位置使用的互斥锁、锁与条件变量类型
+/*
+    未开启统计时锁的类型仍为std::unique_lock<std::mutex>，
+    以便继续使用std::condition_variable
+*/
+#if LOCK_PROFILE_ENABLED
+    using SiteMutex     = ProfiledMutex;
+    using SiteLock      = std::unique_lock<ProfiledMutex>;
+    using SiteLockGuard = std::lock_guard<ProfiledMutex>;
+    using SiteCondVar   = std::condition_variable_any;
+#else
+    using SiteMutex     = NamedMutex;
+    using SiteLock      = std::unique_lock<std::mutex>;
+    using SiteLockGuard = std::lock_guard<std::mutex>;
+    using SiteCondVar   = std::condition_variable;
+#endif
+
+#endif
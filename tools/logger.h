@@ -6,6 +6,8 @@
 #include <mutex>
 #include <cstring>
 
+#include "lockProfiler.h"
+
 #ifndef LOG_ENABLED
 #define LOG_ENABLED 1  // 1: 启用, 0: 禁用
 #endif
@@ -25,7 +27,7 @@ public:
     // 设置全局日志级别
     static void setLevel(LogLevel level) {
         // 加锁
-        std::lock_guard<std::mutex> lock(instance().mutex_);
+        SiteLockGuard lock(instance().mutex_);
         instance().logLevel_ = level;
     }
 
@@ -63,7 +65,7 @@ public:
             ss_ << "\n";
 
             // 加锁
-            std::lock_guard<std::mutex> lock(logger_.mutex_);
+            SiteLockGuard lock(logger_.mutex_);
 
             // 输出日志
             std::cout << ss_.str();
@@ -147,7 +149,7 @@ private:
 
     // 当多个线程同时写入日志时，如果不加锁，
     // 它们的输出可能会相互交织，导致日志混乱
-    std::mutex mutex_;                        // 输出互斥锁
+    SiteMutex mutex_{"Logger::mutex_"};       // 输出互斥锁
 
     LogLevel logLevel_;                       // 当前日志级别
 };
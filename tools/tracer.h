@@ -0,0 +1,280 @@
+#ifndef __TRACER_H__
+#define __TRACER_H__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// 任务生命周期追踪器 - 输出Chrome/Perfetto trace-event格式的JSON
+/*
+    - 默认关闭，关闭时每个埋点只有一次isEnabled()判断
+    - 开启后事件写入每个线程私有的缓冲区，缓冲区的锁仅在导出时才会产生竞争
+    - 线程退出后其缓冲区保留至下一次导出，导出后释放，线程反复创建/回收时缓冲区数量保持有界
+    - 导出的JSON可直接在chrome://tracing或ui.perfetto.dev中打开，
+      同一任务的提交与执行之间以flow箭头相连
+
+    使用示例：
+        Tracer::start();
+        ...
+        Tracer::stop();
+        Tracer::dump("trace.json");
+*/
+class Tracer
+{
+public:
+    // 事件类型，对应trace-event格式中的ph字段
+    enum Phase : char {
+        PHASE_COMPLETE   = 'X',     // 带时长的事件（任务执行）
+        PHASE_INSTANT    = 'i',     // 瞬时事件（提交、出队、线程创建/回收）
+        PHASE_FLOW_BEGIN = 's',     // flow起点（提交）
+        PHASE_FLOW_END   = 'f',     // flow终点（执行）
+    };
+
+    // 开始记录
+    // 时间戳起点只在首次开始时设置，之后stop()/start()共用同一时间轴，跨越重启的任务时间戳仍然有序
+    static void start() {
+        int64_t expected = 0;
+        epochNs_.compare_exchange_strong(expected, steadyNs(), std::memory_order_relaxed);
+        enabled_.store(true, std::memory_order_release);
+    }
+
+    // 停止记录
+    static void stop() {
+        enabled_.store(false, std::memory_order_release);
+    }
+
+    // 是否正在记录
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // 当前时间戳，单位：ns
+    static uint64_t now() {
+        return steadyNs() - epochNs_.load(std::memory_order_relaxed);
+    }
+
+    // 生成任务追踪id
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> id(1);
+        return id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 设置当前线程在追踪视图中显示的名称，未开启记录时只保存名称，不分配缓冲区
+    static void setThreadName(const std::string& name) {
+        threadName_ = name;
+        if(localBuffer_.buffer != nullptr) {
+            std::lock_guard<std::mutex> lock(localBuffer_.buffer->mtx_);
+            localBuffer_.buffer->name_ = name;
+        }
+    }
+
+    // 记录瞬时事件，name与category必须为字符串常量
+    static void instant(const char* name, const char* category, uint64_t id = 0) {
+        record(Event{ name, category, PHASE_INSTANT, now(), 0, id });
+    }
+
+    // 记录带时长的事件
+    static void complete(const char* name, const char* category, uint64_t begin, uint64_t end, uint64_t id = 0) {
+        record(Event{ name, category, PHASE_COMPLETE, begin, end - begin, id });
+    }
+
+    // 记录flow起点/终点，相同id的起点与终点之间显示箭头
+    static void flowBegin(const char* name, const char* category, uint64_t id) {
+        record(Event{ name, category, PHASE_FLOW_BEGIN, now(), 0, id });
+    }
+
+    static void flowEnd(const char* name, const char* category, uint64_t id, uint64_t timestamp) {
+        record(Event{ name, category, PHASE_FLOW_END, timestamp, 0, id });
+    }
+
+    // 导出所有线程的事件并清空缓冲区
+    static bool dump(const std::string& path) {
+        std::ofstream file(path);
+        if(!file) {
+            return false;
+        }
+
+        Tracer& tracer = instance();
+        std::lock_guard<std::mutex> registryLock(tracer.registryMtx_);
+
+        file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+        bool first = true;
+        auto separator = [&]() {
+            file << (first ? "  " : ",\n  ");
+            first = false;
+        };
+
+        int pid = static_cast<int>(getpid());
+        for(auto& buffer : tracer.buffers_) {
+            std::lock_guard<std::mutex> lock(buffer->mtx_);
+
+            separator();
+            file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid
+                 << ", \"tid\": " << buffer->tid_
+                 << ", \"args\": {\"name\": \"";
+            writeEscaped(file, buffer->name_);
+            file << "\"}}";
+
+            for(auto& event : buffer->events_) {
+                separator();
+
+                // trace-event格式的时间单位为us
+                file << "{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category
+                     << "\", \"ph\": \"" << static_cast<char>(event.phase) << "\""
+                     << ", \"ts\": " << event.timestamp / 1000.0
+                     << ", \"pid\": " << pid << ", \"tid\": " << buffer->tid_;
+
+                if(event.phase == PHASE_COMPLETE) {
+                    file << ", \"dur\": " << event.duration / 1000.0;
+                }
+                else if(event.phase == PHASE_INSTANT) {
+                    file << ", \"s\": \"t\"";
+                }
+                else {
+                    // flow终点绑定到包含该时间点的执行事件上
+                    file << ", \"id\": " << event.id;
+                    if(event.phase == PHASE_FLOW_END) {
+                        file << ", \"bp\": \"e\"";
+                    }
+                }
+
+                if(event.id != 0 && (event.phase == PHASE_COMPLETE || event.phase == PHASE_INSTANT)) {
+                    file << ", \"args\": {\"task\": " << event.id << "}";
+                }
+                file << "}";
+            }
+            buffer->events_.clear();
+        }
+
+        // 已退出线程的事件已全部导出，释放其缓冲区
+        tracer.buffers_.erase(std::remove_if(tracer.buffers_.begin(), tracer.buffers_.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+            std::lock_guard<std::mutex> lock(buffer->mtx_);
+            return buffer->exited_;
+        }), tracer.buffers_.end());
+
+        file << "\n]}\n";
+        return true;
+    }
+
+private:
+    // 追踪事件，只保存字符串常量的指针，避免记录时的内存分配
+    struct Event
+    {
+        const char* name;
+        const char* category;
+        Phase phase;
+        uint64_t timestamp;
+        uint64_t duration;
+        uint64_t id;
+    };
+
+    // 线程私有的事件缓冲区
+    struct ThreadBuffer
+    {
+        std::mutex mtx_;                    // 仅在导出时与记录线程产生竞争
+        std::vector<Event> events_;         // 事件
+        std::string name_;                  // 线程名称
+        long tid_;                          // 系统线程id
+        bool exited_ = false;               // 线程是否已退出，退出后导出一次即释放
+    };
+
+    // 当前线程持有的缓冲区，线程退出时标记缓冲区已退出
+    struct LocalBuffer
+    {
+        LocalBuffer() : buffer(nullptr) {}
+
+        ~LocalBuffer() {
+            if(buffer != nullptr) {
+                std::lock_guard<std::mutex> lock(buffer->mtx_);
+                buffer->exited_ = true;
+                buffer = nullptr;
+            }
+        }
+
+        ThreadBuffer* buffer;               // 已注册的缓冲区，由注册表持有
+    };
+
+    Tracer() = default;
+
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    // 当前线程的缓冲区，首次使用时注册，线程退出后缓冲区保留至导出
+    static ThreadBuffer& localBuffer() {
+        if(localBuffer_.buffer == nullptr) {
+            auto owned = std::make_shared<ThreadBuffer>();
+            owned->tid_ = static_cast<long>(syscall(SYS_gettid));
+            owned->name_ = threadName_.empty() ? "Thread-" + std::to_string(owned->tid_) : threadName_;
+
+            Tracer& tracer = instance();
+            std::lock_guard<std::mutex> lock(tracer.registryMtx_);
+            tracer.buffers_.emplace_back(owned);
+            localBuffer_.buffer = owned.get();
+        }
+        return *localBuffer_.buffer;
+    }
+
+    // 写入当前线程的缓冲区
+    static void record(const Event& event) {
+        ThreadBuffer& buffer = localBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mtx_);
+        buffer.events_.push_back(event);
+    }
+
+    // 以JSON字符串转义写出，线程名称来自用户设置的前缀，可能包含引号、反斜杠或控制字符
+    static void writeEscaped(std::ostream& os, const std::string& str) {
+        for(char c : str) {
+            switch(c) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                    os << buf;
+                }
+                else {
+                    os << c;
+                }
+            }
+        }
+    }
+
+    // steady_clock的当前时间，单位：ns
+    static int64_t steadyNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static inline std::atomic_bool enabled_{false};             // 是否正在记录
+    static inline thread_local LocalBuffer localBuffer_;                // 当前线程的缓冲区
+    static inline thread_local std::string threadName_;                 // 当前线程的名称
+    static inline std::atomic<int64_t> epochNs_{0};             // 时间戳起点，单位：ns，0表示尚未开始过
+    std::mutex registryMtx_;                                    // 保证缓冲区容器的线程安全
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;        // 所有线程的缓冲区
+};
+
+#endif